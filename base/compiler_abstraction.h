@@ -0,0 +1,56 @@
+/**
+ * @file        compiler_abstraction.h
+ * @brief       Compiler abstraction macros
+ * @details     This header wraps compiler specific keywords and attributes behind
+ *              portable macros. On compilers without GNU extensions the macros
+ *              degrade to plain C so the code still builds, only without the hints.
+ */
+
+#ifndef COMPILER_ABSTRACTION_H
+#define COMPILER_ABSTRACTION_H
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/**
+ * @brief   Branch prediction hints
+ * @details LIKELY/UNLIKELY tell the compiler which outcome of a condition is
+ *          expected so that the expected path is laid out as the fall-through.
+ */
+#define LIKELY(x)           __builtin_expect(!!(x), 1)
+#define UNLIKELY(x)         __builtin_expect(!!(x), 0)
+
+/**
+ * @brief   Function placement attributes
+ * @details ATTR_COLD moves rarely executed functions out of the hot text section,
+ *          ATTR_NOINLINE keeps a function out-of-line.
+ */
+#define ATTR_COLD           __attribute__((cold))
+#define ATTR_NOINLINE       __attribute__((noinline))
+
+/**
+ * @brief   Data layout attributes
+ * @details ATTR_ALIGNED(n) raises the alignment of a variable or member to n bytes,
+ *          ATTR_MAY_ALIAS allows a type to access memory declared with another type.
+ */
+#define ATTR_ALIGNED(n)     __attribute__((aligned(n)))
+#define ATTR_MAY_ALIAS      __attribute__((may_alias))
+
+#else
+
+#define LIKELY(x)           (x)
+#define UNLIKELY(x)         (x)
+#define ATTR_COLD
+#define ATTR_NOINLINE
+#define ATTR_ALIGNED(n)
+#define ATTR_MAY_ALIAS
+
+#endif
+
+/**
+ * @brief   Inline function definition in a header
+ * @details Functions defined with LOCAL_INLINE get internal linkage in every
+ *          translation unit that includes them, so no external definition is needed.
+ */
+#define LOCAL_INLINE        static inline
+
+#endif /* COMPILER_ABSTRACTION_H */
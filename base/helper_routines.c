@@ -7,6 +7,116 @@
 
 #include "helper_routines.h"
 
+/* Bytes written per iteration of the unrolled fill loop */
+#define FILL_CHUNK_BYTES    (64U)
+
+/**
+ * @brief Fill memory with a byte value, one vector or word at a time
+ * 
+ * @param ptr Pointer to the memory to fill
+ * @param byte_value Value to store in every byte
+ * @param num Number of bytes to fill
+ * @param streaming TRUE to use non-temporal stores for the aligned body
+ * 
+ * @details The unaligned head is filled byte by byte until ptr reaches a 16 byte
+ *          boundary, the body is filled in 64 byte chunks of aligned stores and
+ *          the remaining tail byte by byte again. When streaming, the head from a
+ *          4 byte boundary on and the 16 and 4 byte steps of the tail use
+ *          non-temporal stores too, so blocks smaller than a chunk still bypass the
+ *          cache; only bytes outside 4 byte alignment are written normally.
+ */
+static void fill(uint8* ptr, uint8 byte_value, uintptr num, boolean streaming)
+{
+#if defined(__SSE2__)
+    sint32 pattern32 = (sint32)((uint32)byte_value * 0x01010101U);
+#endif
+
+    /* Head: reach 16 byte alignment */
+    while ((num > 0U) && (0U != ((uintptr)ptr & 15U)))
+    {
+#if defined(__SSE2__)
+        if ((TRUE == streaming) && (num >= 4U) && (0U == ((uintptr)ptr & 3U)))
+        {
+            _mm_stream_si32((int*)ptr, pattern32);
+            ptr += 4U;
+            num -= 4U;
+            continue;
+        }
+#endif
+        *ptr++ = byte_value;
+        num--;
+    }
+
+#if defined(__SSE2__)
+    {
+        __m128i pattern = _mm_set1_epi8((char)byte_value);
+
+        if (TRUE == streaming)
+        {
+            while (num >= FILL_CHUNK_BYTES)
+            {
+                _mm_stream_si128((__m128i*)(ptr +  0), pattern);
+                _mm_stream_si128((__m128i*)(ptr + 16), pattern);
+                _mm_stream_si128((__m128i*)(ptr + 32), pattern);
+                _mm_stream_si128((__m128i*)(ptr + 48), pattern);
+                ptr += FILL_CHUNK_BYTES;
+                num -= FILL_CHUNK_BYTES;
+            }
+            while (num >= 16U)
+            {
+                _mm_stream_si128((__m128i*)ptr, pattern);
+                ptr += 16U;
+                num -= 16U;
+            }
+            while (num >= 4U)
+            {
+                _mm_stream_si32((int*)ptr, pattern32);
+                ptr += 4U;
+                num -= 4U;
+            }
+            _mm_sfence();  /* Order the streaming stores before later accesses */
+        }
+        else
+        {
+            while (num >= FILL_CHUNK_BYTES)
+            {
+                _mm_store_si128((__m128i*)(ptr +  0), pattern);
+                _mm_store_si128((__m128i*)(ptr + 16), pattern);
+                _mm_store_si128((__m128i*)(ptr + 32), pattern);
+                _mm_store_si128((__m128i*)(ptr + 48), pattern);
+                ptr += FILL_CHUNK_BYTES;
+                num -= FILL_CHUNK_BYTES;
+            }
+            while (num >= 16U)
+            {
+                _mm_store_si128((__m128i*)ptr, pattern);
+                ptr += 16U;
+                num -= 16U;
+            }
+        }
+    }
+#else
+    {
+        mem_word pattern = (mem_word)byte_value * 0x0101010101010101ULL;
+
+        (void)streaming;  /* No portable non-temporal store */
+        while (num >= sizeof(mem_word))
+        {
+            *(mem_word*)ptr = pattern;
+            ptr += sizeof(mem_word);
+            num -= sizeof(mem_word);
+        }
+    }
+#endif
+
+    /* Tail */
+    while (num > 0U)
+    {
+        *ptr++ = byte_value;
+        num--;
+    }
+}
+
 /**
  * @brief Fill a block of memory with a specified value
  * 
@@ -16,22 +126,37 @@
  * @return void* A pointer to the memory area dest, or NULL if dest is NULL
  * 
  * @note This implementation is optimized for performance while maintaining
- *       portability and safety with NULL pointer checks.
+ *       portability and safety with NULL pointer checks. Fills of at least
+ *       MEM_NT_THRESHOLD bytes bypass the cache with non-temporal stores.
  */
-void* mem_set(void* dest, sint32 value, uint32 num) 
+void* mem_set(void* dest, sint32 value, uintptr num) 
 {
-    uint8* ptr = (uint8*)dest;
-    uint8 byte_value = (uint8)value;
-    
     if (dest == NULL_PTR) 
     {
         return NULL_PTR;
     }
     
-    while (num-- > 0) 
+    fill((uint8*)dest, (uint8)value, num, (boolean)(num >= MEM_NT_THRESHOLD));
+    
+    return dest;
+}
+
+/**
+ * @brief Fill a block of memory using non-temporal stores
+ * 
+ * @param dest Pointer to the block of memory to fill
+ * @param value Value to be set (converted to an unsigned char)
+ * @param num Number of bytes to be set to the value
+ * @return void* A pointer to the memory area dest, or NULL if dest is NULL
+ */
+void* mem_set_nt(void* dest, sint32 value, uintptr num)
+{
+    if (dest == NULL_PTR) 
     {
-        *ptr++ = byte_value;
+        return NULL_PTR;
     }
     
+    fill((uint8*)dest, (uint8)value, num, TRUE);
+    
     return dest;
-}
\ No newline at end of file
+}
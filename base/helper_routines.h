@@ -9,6 +9,30 @@
 #define HELPER_ROUTINES_H
 
 #include "std_types.h"  /* For standard types */
+#include "compiler_abstraction.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size from which mem_set() switches to non-temporal stores
+ * @details Fills larger than the last level cache would only evict useful data,
+ *          so from this size on the stores bypass the cache.
+ */
+#ifndef MEM_NT_THRESHOLD
+#define MEM_NT_THRESHOLD    (4U * 1024U * 1024U)
+#endif
+
+/**
+ * @brief   Machine word used by the word-at-a-time kernels
+ * @details Declared may_alias so that it can be used on memory of any declared type.
+ */
+typedef uint64 ATTR_MAY_ALIAS mem_word;
 
 /**
  * @brief Fill a block of memory with a specified value
@@ -20,7 +44,106 @@
  * 
  * @note This is a custom implementation of the standard memset function.
  *       It handles NULL pointer checks and returns NULL if dest is NULL.
+ *       Fills of MEM_NT_THRESHOLD bytes or more use non-temporal stores.
  */
-void* mem_set(void* dest, sint32 value, uint32 num);
+void* mem_set(void* dest, sint32 value, uintptr num);
+
+/**
+ * @brief Fill a block of memory using non-temporal stores
+ * 
+ * @param dest Pointer to the block of memory to fill
+ * @param value Value to be set (converted to an unsigned char)
+ * @param num Number of bytes to be set to the value
+ * @return void* A pointer to the memory area dest, or NULL if dest is NULL
+ * 
+ * @note The written lines are not kept in the cache. Use it for large areas and for
+ *       blocks that are not read back soon. Every 4 byte aligned word is streamed,
+ *       whatever the size; only bytes outside 4 byte alignment use regular stores.
+ *       Falls back to regular stores without SSE2.
+ */
+void* mem_set_nt(void* dest, sint32 value, uintptr num);
+
+/**
+ * @brief Zero a fixed-size block
+ * 
+ * @param dest Pointer to the block, must be aligned to 8 bytes
+ * @param size Size in bytes, expected to be a compile-time constant
+ * 
+ * @note Inlined so that a constant size unrolls into straight vector or word
+ *       stores. No NULL check is performed.
+ */
+LOCAL_INLINE void mem_zero_fixed(void* dest, uint32 size)
+{
+    uint8* ptr = (uint8*)dest;
+    uint32 i;
+
+#if defined(__SSE2__)
+    if (0U == (size % 16U))
+    {
+        __m128i zero = _mm_setzero_si128();
+        for (i = 0U; i < size; i += 16U)
+        {
+            _mm_storeu_si128((__m128i*)(ptr + i), zero);
+        }
+        return;
+    }
+#endif
+    if (0U == (size % sizeof(mem_word)))
+    {
+        for (i = 0U; i < size; i += (uint32)sizeof(mem_word))
+        {
+            *(mem_word*)(ptr + i) = 0U;
+        }
+        return;
+    }
+    for (i = 0U; i < size; i++)
+    {
+        ptr[i] = 0U;
+    }
+}
+
+/**
+ * @brief Copy a fixed-size block
+ * 
+ * @param dest Pointer to the destination block, must be aligned to 8 bytes
+ * @param src  Pointer to the source block, must be aligned to 8 bytes
+ * @param size Size in bytes, expected to be a compile-time constant
+ * 
+ * @note Inlined so that a constant size unrolls into straight vector or word
+ *       moves. The blocks must not overlap. No NULL check is performed.
+ */
+LOCAL_INLINE void mem_copy_fixed(void* dest, const void* src, uint32 size)
+{
+    uint8* to = (uint8*)dest;
+    const uint8* from = (const uint8*)src;
+    uint32 i;
+
+#if defined(__SSE2__)
+    if (0U == (size % 16U))
+    {
+        for (i = 0U; i < size; i += 16U)
+        {
+            _mm_storeu_si128((__m128i*)(to + i), _mm_loadu_si128((const __m128i*)(from + i)));
+        }
+        return;
+    }
+#endif
+    if (0U == (size % sizeof(mem_word)))
+    {
+        for (i = 0U; i < size; i += (uint32)sizeof(mem_word))
+        {
+            *(mem_word*)(to + i) = *(const mem_word*)(from + i);
+        }
+        return;
+    }
+    for (i = 0U; i < size; i++)
+    {
+        to[i] = from[i];
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* HELPER_ROUTINES_H */
@@ -35,6 +35,16 @@ typedef unsigned int uint32;
  */
 typedef unsigned long long uint64;
 
+/**
+ * @brief   Unsigned integer with the width of a pointer
+ * @details Used for address arithmetic such as alignment checks.
+ */
+#if defined(_WIN64)
+typedef unsigned long long uintptr;
+#else
+typedef unsigned long uintptr;
+#endif
+
 /* Signed integer types */
 
 /**
@@ -95,6 +105,19 @@ typedef uint8 boolean;
 #define TRUE    (1u)
 #endif
 
+/**
+ * @brief   Standard switch values
+ * @details These values are used by configuration switches to enable or
+ *          disable optional features at build time.
+ */
+#ifndef STD_ON
+#define STD_ON  (1u)
+#endif
+
+#ifndef STD_OFF
+#define STD_OFF (0u)
+#endif
+
 /* Standard return type */
 
 /**
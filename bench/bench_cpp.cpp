@@ -0,0 +1,292 @@
+/**
+ * @file        bench_cpp.cpp
+ * @brief       Benchmarks for the C++ interface of the memory pool
+ * @details     Uses the same iteration scheme as bench_pool.c: the best of several
+ *              measurements of a fixed number of calls is reported.
+ */
+
+ #include <coroutine>
+ #include <cstdio>
+ #include <exception>
+ #include <list>
+ #include <map>
+ #include <memory_resource>
+ #include <utility>
+ #include <vector>
+ #include "bench_pool.h"
+ #include "bench_timer.h"
+ #include "pool.h"
+ #include "static_pool.hpp"
+ #include "pool_allocator.hpp"
+ #include "pool_coro.hpp"
+ 
+ /* Iterations per measurement and number of measurements */
+ #define BENCH_ITERATIONS  (1000000U)
+ #define BENCH_REPEATS     (5U)
+ 
+ /* Elements per container fill and number of fill/empty rounds per measurement */
+ #define BENCH_NODES       (1000U)
+ #define BENCH_ROUNDS      (200U)
+ 
+ /* Node pool for the container benchmarks, large enough for list and map nodes */
+ using NodePool = StaticPool<64U, BENCH_NODES>;
+ static NodePool bench_node_pool;
+ 
+ /* Coroutines alive at once in the frame benchmark */
+ #define BENCH_CORO_BATCH  (64U)
+ 
+ /* Same geometry as the C benchmark pool */
+ constinit static StaticPool<POOL_BLOCK_SIZE, POOL_NUM_BLOCKS> bench_static_pool;
+ static TPool_handle bench_c_pool;
+ 
+ /* Coroutine frame size classes above the C pool */
+ using FramePool4 = StaticPool<POOL_BLOCK_SIZE * 4U, BENCH_CORO_BATCH>;
+ using FramePool16 = StaticPool<POOL_BLOCK_SIZE * 16U, BENCH_CORO_BATCH>;
+ constinit static FramePool4 bench_frame_pool4;
+ constinit static FramePool16 bench_frame_pool16;
+ constinit static FramePools<TPool_handle, FramePool4, FramePool16> bench_frames{bench_c_pool, bench_frame_pool4, bench_frame_pool16};
+ 
+ /**
+  * @brief Compare StaticPool with the inlined C fast path
+  * @details One block is kept allocated, as in the C alloc/free benchmark.
+  */
+ static void bench_static_pool_alloc_free(void)
+ {
+     uint64 best_c = ~0ULL;
+     uint64 best_checked = ~0ULL;
+     uint64 best_unchecked = ~0ULL;
+     
+     pool_init(&bench_c_pool);
+     (void)pool_alloc(&bench_c_pool);
+     (void)bench_static_pool.allocate();
+     
+     for (uint32 r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (uint32 i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_alloc_fast(&bench_c_pool);
+             BENCH_KEEP(block);
+             pool_free_fast(&bench_c_pool, block);
+         }
+         uint64 ticks = bench_ticks() - start;
+         best_c = (ticks < best_c) ? ticks : best_c;
+         
+         start = bench_ticks();
+         for (uint32 i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = bench_static_pool.allocate();
+             BENCH_KEEP(block);
+             bench_static_pool.deallocate(block);
+         }
+         ticks = bench_ticks() - start;
+         best_checked = (ticks < best_checked) ? ticks : best_checked;
+         
+         start = bench_ticks();
+         for (uint32 i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = bench_static_pool.allocate();
+             BENCH_KEEP(block);
+             bench_static_pool.deallocate_unchecked(block);
+         }
+         ticks = bench_ticks() - start;
+         best_unchecked = (ticks < best_unchecked) ? ticks : best_unchecked;
+     }
+     
+     std::printf("\nC++ StaticPool<%u, %u>\n", POOL_BLOCK_SIZE, POOL_NUM_BLOCKS);
+     bench_report("pool_alloc_fast + pool_free_fast", best_c, BENCH_ITERATIONS);
+     bench_report("allocate + deallocate", best_checked, BENCH_ITERATIONS);
+     bench_report("allocate + deallocate_unchecked", best_unchecked, BENCH_ITERATIONS);
+ }
+ 
+ /**
+  * @brief Best cost of filling a container with BENCH_NODES elements and emptying it
+  * @details Every element is inserted at the back and erased from the front, so
+  *          the reported cost per call is one insert plus one erase.
+  */
+ template <typename Container>
+ static uint64 bench_fill_empty(Container& container)
+ {
+     uint64 best = ~0ULL;
+     
+     for (uint32 r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (uint32 round = 0U; round < BENCH_ROUNDS; round++)
+         {
+             for (uint32 i = 0U; i < BENCH_NODES; i++)
+             {
+                 container.emplace_hint(container.end(), i, i);
+             }
+             while (!container.empty())
+             {
+                 container.erase(container.begin());
+             }
+         }
+         uint64 ticks = bench_ticks() - start;
+         best = (ticks < best) ? ticks : best;
+     }
+     return best;
+ }
+ 
+ /**
+  * @brief std::list has no emplace_hint; adapt it to the map interface
+  */
+ template <typename Allocator>
+ struct bench_list : std::list<uint32, Allocator>
+ {
+     using std::list<uint32, Allocator>::list;
+     
+     void emplace_hint(typename std::list<uint32, Allocator>::iterator pos, uint32 key, uint32 value)
+     {
+         this->emplace(pos, key + value);
+     }
+ };
+ 
+ /**
+  * @brief Compare list and map node allocation through the pool adapters
+  */
+ static void bench_containers(void)
+ {
+     const uint32 calls = BENCH_NODES * BENCH_ROUNDS;
+     
+     std::printf("\nContainers of %u nodes, insert + erase\n", BENCH_NODES);
+     {
+         bench_list<std::allocator<uint32>> list;
+         bench_report("list, std::allocator", bench_fill_empty(list), calls);
+     }
+     {
+         bench_list<PoolAllocator<uint32, NodePool>> list(PoolAllocator<uint32, NodePool>{bench_node_pool});
+         bench_report("list, PoolAllocator", bench_fill_empty(list), calls);
+     }
+     {
+         std::pmr::unsynchronized_pool_resource resource;
+         bench_list<std::pmr::polymorphic_allocator<uint32>> list(&resource);
+         bench_report("list, unsynchronized_pool_resource", bench_fill_empty(list), calls);
+     }
+     {
+         basic_pool_memory_resource<NodePool> resource(bench_node_pool);
+         bench_list<std::pmr::polymorphic_allocator<uint32>> list(&resource);
+         bench_report("list, pool_memory_resource", bench_fill_empty(list), calls);
+     }
+     {
+         std::map<uint32, uint32> map;
+         bench_report("map, std::allocator", bench_fill_empty(map), calls);
+     }
+     {
+         using Alloc = PoolAllocator<std::pair<const uint32, uint32>, NodePool>;
+         std::map<uint32, uint32, std::less<uint32>, Alloc> map(Alloc{bench_node_pool});
+         bench_report("map, PoolAllocator", bench_fill_empty(map), calls);
+     }
+     {
+         std::pmr::unsynchronized_pool_resource resource;
+         std::pmr::map<uint32, uint32> map(&resource);
+         bench_report("map, unsynchronized_pool_resource", bench_fill_empty(map), calls);
+     }
+     {
+         basic_pool_memory_resource<NodePool> resource(bench_node_pool);
+         std::pmr::map<uint32, uint32> map(&resource);
+         bench_report("map, pool_memory_resource", bench_fill_empty(map), calls);
+     }
+ }
+ 
+ /**
+  * @brief Lazily started coroutine; Base supplies the frame allocation
+  */
+ template <typename Base>
+ struct BenchTask
+ {
+     struct promise_type : Base
+     {
+         BenchTask get_return_object() noexcept
+         {
+             return BenchTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+         }
+         std::suspend_always initial_suspend() noexcept { return {}; }
+         std::suspend_always final_suspend() noexcept { return {}; }
+         void return_void() noexcept {}
+         void unhandled_exception() noexcept { std::terminate(); }
+     };
+     
+     explicit BenchTask(std::coroutine_handle<promise_type> h) noexcept : handle(h) {}
+     BenchTask(BenchTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+     ~BenchTask()
+     {
+         if (handle)
+         {
+             handle.destroy();
+         }
+     }
+     
+     std::coroutine_handle<promise_type> handle;
+ };
+ 
+ /* Frames from the global operator new */
+ struct DefaultFramePromise {};
+ 
+ template <typename Base>
+ static BenchTask<Base> bench_step(uint32& total, uint32 step)
+ {
+     total += step;
+     co_await std::suspend_always{};
+     total += step;
+ }
+ 
+ /**
+  * @brief Best cost of spawning, resuming to completion and destroying a coroutine
+  * @details Coroutines are spawned in batches of BENCH_CORO_BATCH so that several
+  *          frames are alive at once, as in a server with requests in flight.
+  */
+ template <typename Base>
+ static uint64 bench_coro_batches(void)
+ {
+     std::vector<BenchTask<Base>> tasks;
+     uint64 best = ~0ULL;
+     uint32 total = 0U;
+     
+     tasks.reserve(BENCH_CORO_BATCH);
+     for (uint32 r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (uint32 batch = 0U; batch < (BENCH_ITERATIONS / BENCH_CORO_BATCH); batch++)
+         {
+             for (uint32 i = 0U; i < BENCH_CORO_BATCH; i++)
+             {
+                 tasks.push_back(bench_step<Base>(total, i));
+             }
+             for (BenchTask<Base>& task : tasks)
+             {
+                 task.handle.resume();
+                 task.handle.resume();
+             }
+             tasks.clear();
+         }
+         uint64 ticks = bench_ticks() - start;
+         best = (ticks < best) ? ticks : best;
+     }
+     BENCH_KEEP(total);
+     return best;
+ }
+ 
+ /**
+  * @brief Compare pooled and default coroutine frame allocation
+  */
+ static void bench_coro_frames(void)
+ {
+     const uint32 calls = (BENCH_ITERATIONS / BENCH_CORO_BATCH) * BENCH_CORO_BATCH;
+     
+     pool_init(&bench_c_pool);
+     std::printf("\nCoroutines in batches of %u, spawn + resume + destroy\n", BENCH_CORO_BATCH);
+     bench_report("operator new frames", bench_coro_batches<DefaultFramePromise>(), calls);
+     bench_report("FramePools frames", bench_coro_batches<pool_frame_promise<bench_frames>>(), calls);
+ }
+ 
+ /**
+  * @brief Run the benchmarks of the C++ interface
+  */
+ extern "C" void run_cpp_benchmarks(void)
+ {
+     bench_static_pool_alloc_free();
+     bench_containers();
+     bench_coro_frames();
+ }
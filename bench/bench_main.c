@@ -0,0 +1,23 @@
+/**
+ * @file        bench_main.c
+ * @brief       Benchmark application entry point
+ * @details     This file contains the main function to run the memory pool benchmarks
+ */
+
+ #include <stdio.h>
+ #include "bench_pool.h"
+ 
+ /**
+  * @brief Main function
+  * @return int 0 on success, non-zero on failure
+  */
+ int main(void)
+ {
+     printf("Memory Pool Allocator Benchmarks\n");
+     printf("================================\n\n");
+     
+     run_all_benchmarks();
+     
+     printf("\nBenchmark execution complete.\n");
+     return 0;
+ }
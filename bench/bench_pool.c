@@ -0,0 +1,461 @@
+/**
+ * @file        bench_pool.c
+ * @brief       Benchmarks for static memory pool implementation
+ * @details     Each benchmark runs a fixed number of iterations several times and
+ *              reports the best per-call cost, which filters out interrupts and
+ *              frequency ramp-up.
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include "bench_pool.h"
+ #include "pool.h"
+ #include "helper_routines.h"
+ #include "pool_numa.h"
+ #include "pool_registry.h"
+ #include "pool_define.h"
+ #include "pool_cache.h"
+ #include "pool_quota.h"
+ #include "pool_os.h"
+ #include "bench_timer.h"
+ 
+ /* Iterations per measurement and number of measurements */
+ #define BENCH_ITERATIONS  (1000000U)
+ #define BENCH_REPEATS     (5U)
+ 
+ /* Size of the buffer used by the large fill benchmarks */
+ #define BENCH_FILL_BYTES  (64U * 1024U * 1024U)
+ 
+ /* Benchmark pool handle */
+ static TPool_handle bench_pool;
+ 
+ /* Same geometry, specialized through POOL_DEFINE() */
+ POOL_DEFINE(bench_defined, POOL_BLOCK_SIZE, POOL_NUM_BLOCKS)
+ static TPool_bench_defined bench_defined_pool;
+ 
+ /* Benchmark function declarations */
+ static void bench_alloc_free(void);
+ static void bench_mem_set(void);
+ static void bench_block_kernels(void);
+ static void bench_numa(void);
+ static void bench_cache(void);
+ static void bench_quota(void);
+ 
+ /* Called through volatile pointers so the compiler emits real libc calls */
+ static void* (*volatile libc_memset)(void*, int, size_t) = memset;
+ static void* (*volatile libc_memcpy)(void*, const void*, size_t) = memcpy;
+ 
+ /**
+  * @brief Run all benchmarks
+  */
+ void run_all_benchmarks(void)
+ {
+     printf("Pool: %u blocks of %u bytes\n\n", POOL_NUM_BLOCKS, POOL_BLOCK_SIZE);
+     
+     bench_alloc_free();
+     bench_mem_set();
+     bench_block_kernels();
+     bench_numa();
+     bench_cache();
+     bench_quota();
+     run_cpp_benchmarks();
+ }
+ 
+ /**
+  * @brief Print the best per-unit cost of a measurement series
+  */
+ static void report_per(const char* name, uint64 best_ticks, uint32 units, const char* unit)
+ {
+     printf("%-40s %8.2f %s/%s\n", name, (float64)best_ticks / (float64)units, BENCH_TICK_UNIT, unit);
+ }
+ 
+ /**
+  * @brief Print the best per-call cost of a measurement series
+  */
+ void bench_report(const char* name, uint64 best_ticks, uint32 calls)
+ {
+     report_per(name, best_ticks, calls, "call");
+ }
+ 
+ /**
+  * @brief Compare the out-of-line and the inlined alloc/free paths
+  * @details One block is kept allocated so the pool is never completely
+  *          empty; each iteration allocates and frees one more block.
+  */
+ static void bench_alloc_free(void)
+ {
+     uint64 best_call = ~0ULL;
+     uint64 best_inline = ~0ULL;
+     uint64 best_ptr = ~0ULL;
+     uint64 best_defined = ~0ULL;
+     uint32 r;
+     uint32 i;
+     void* anchor;
+     
+     pool_init(&bench_pool);
+     (void)pool_register(&bench_pool);
+     anchor = pool_alloc(&bench_pool);
+     (void)bench_defined_alloc(&bench_defined_pool);
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_alloc(&bench_pool);
+             BENCH_KEEP(block);
+             pool_free(&bench_pool, block);
+         }
+         uint64 ticks = bench_ticks() - start;
+         best_call = (ticks < best_call) ? ticks : best_call;
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_alloc_fast(&bench_pool);
+             BENCH_KEEP(block);
+             pool_free_fast(&bench_pool, block);
+         }
+         ticks = bench_ticks() - start;
+         best_inline = (ticks < best_inline) ? ticks : best_inline;
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_alloc(&bench_pool);
+             BENCH_KEEP(block);
+             pool_free_ptr(block);
+         }
+         ticks = bench_ticks() - start;
+         best_ptr = (ticks < best_ptr) ? ticks : best_ptr;
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = bench_defined_alloc(&bench_defined_pool);
+             BENCH_KEEP(block);
+             bench_defined_free(&bench_defined_pool, block);
+         }
+         ticks = bench_ticks() - start;
+         best_defined = (ticks < best_defined) ? ticks : best_defined;
+     }
+     
+     pool_free(&bench_pool, anchor);
+     pool_unregister(&bench_pool);
+     
+     bench_report("pool_alloc + pool_free", best_call, BENCH_ITERATIONS);
+     bench_report("pool_alloc_fast + pool_free_fast", best_inline, BENCH_ITERATIONS);
+     bench_report("pool_alloc + pool_free_ptr", best_ptr, BENCH_ITERATIONS);
+     bench_report("POOL_DEFINE alloc + free", best_defined, BENCH_ITERATIONS);
+ }
+ 
+ /**
+  * @brief Compare large fills against libc memset
+  */
+ static void bench_mem_set(void)
+ {
+     uint64 best_libc = ~0ULL;
+     uint64 best_mem_set = ~0ULL;
+     uint64 best_nt = ~0ULL;
+     uint8* buf = (uint8*)malloc(BENCH_FILL_BYTES);
+     uint32 r;
+     
+     if (NULL_PTR == buf)
+     {
+         return;
+     }
+     libc_memset(buf, 1, BENCH_FILL_BYTES);  /* Fault in every page first */
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         libc_memset(buf, 0, BENCH_FILL_BYTES);
+         uint64 ticks = bench_ticks() - start;
+         best_libc = (ticks < best_libc) ? ticks : best_libc;
+         
+         start = bench_ticks();
+         mem_set(buf, 0, BENCH_FILL_BYTES);
+         ticks = bench_ticks() - start;
+         best_mem_set = (ticks < best_mem_set) ? ticks : best_mem_set;
+         
+         start = bench_ticks();
+         mem_set_nt(buf, 0, BENCH_FILL_BYTES);
+         ticks = bench_ticks() - start;
+         best_nt = (ticks < best_nt) ? ticks : best_nt;
+     }
+     BENCH_KEEP(buf[BENCH_FILL_BYTES - 1U]);
+     free(buf);
+     
+     printf("\nFill of %u MiB\n", BENCH_FILL_BYTES >> 20);
+     report_per("libc memset", best_libc, BENCH_FILL_BYTES >> 10, "KiB");
+     report_per("mem_set", best_mem_set, BENCH_FILL_BYTES >> 10, "KiB");
+     report_per("mem_set_nt", best_nt, BENCH_FILL_BYTES >> 10, "KiB");
+ }
+ 
+ /**
+  * @brief Compare the block-sized kernels against libc memset/memcpy
+  */
+ static void bench_block_kernels(void)
+ {
+     uint64 best[4] = { ~0ULL, ~0ULL, ~0ULL, ~0ULL };
+     uint64 start;
+     uint64 ticks;
+     uint32 r;
+     uint32 i;
+     uint8* src;
+     uint8* dst;
+     
+     pool_init(&bench_pool);
+     src = (uint8*)pool_alloc(&bench_pool);
+     dst = (uint8*)pool_alloc(&bench_pool);
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             libc_memset(dst, 0, POOL_BLOCK_SIZE);
+         }
+         ticks = bench_ticks() - start;
+         best[0] = (ticks < best[0]) ? ticks : best[0];
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             pool_block_zero(dst);
+             BENCH_KEEP(dst);
+         }
+         ticks = bench_ticks() - start;
+         best[1] = (ticks < best[1]) ? ticks : best[1];
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             libc_memcpy(dst, src, POOL_BLOCK_SIZE);
+         }
+         ticks = bench_ticks() - start;
+         best[2] = (ticks < best[2]) ? ticks : best[2];
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             pool_block_copy(dst, src);
+             BENCH_KEEP(dst);
+         }
+         ticks = bench_ticks() - start;
+         best[3] = (ticks < best[3]) ? ticks : best[3];
+     }
+     
+     pool_free(&bench_pool, src);
+     pool_free(&bench_pool, dst);
+     
+     printf("\nBlock of %u bytes\n", POOL_BLOCK_SIZE);
+     bench_report("libc memset", best[0], BENCH_ITERATIONS);
+     bench_report("pool_block_zero", best[1], BENCH_ITERATIONS);
+     bench_report("libc memcpy", best[2], BENCH_ITERATIONS);
+     bench_report("pool_block_copy", best[3], BENCH_ITERATIONS);
+ }
+ 
+ /**
+  * @brief Time reading and writing a buffer placed on one NUMA node
+  * @return uint64 Best time of BENCH_REPEATS passes, or 0 if the buffer cannot be bound
+  */
+ static uint64 time_placement(uint8* buf, uint32 node)
+ {
+     uint64 best = ~0ULL;
+     uint32 r;
+     uint32 i;
+     
+     if (STD_OK != pool_os_numa_bind(buf, BENCH_FILL_BYTES, node))
+     {
+         return 0U;
+     }
+     libc_memset(buf, 1, BENCH_FILL_BYTES);  /* Fault in (or migrate) the pages */
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 sum = 0U;
+         uint64 start = bench_ticks();
+         for (i = 0U; i < BENCH_FILL_BYTES; i += 64U)
+         {
+             buf[i]++;
+             sum += buf[i + 32U];
+         }
+         BENCH_KEEP(sum);
+         uint64 ticks = bench_ticks() - start;
+         best = (ticks < best) ? ticks : best;
+     }
+     return best;
+ }
+ 
+ /**
+  * @brief Compare local and remote placement and the cost of node routing
+  */
+ static void bench_numa(void)
+ {
+     static struct { TPool_handle pool ATTR_ALIGNED(4096); } node_storage[POOL_NUMA_MAX_NODES];  /* One page run per node */
+     TPool_handle* pools[POOL_NUMA_MAX_NODES];
+     uint32 node_count = pool_os_numa_node_count();
+     uint32 num_pools = (node_count < POOL_NUMA_MAX_NODES) ? node_count : POOL_NUMA_MAX_NODES;
+     uint64 best = ~0ULL;
+     TPool_numa numa;
+     uint32 r;
+     uint32 i;
+     
+     printf("\nNUMA (%u node(s))\n", node_count);
+     
+     for (i = 0U; i < num_pools; i++)
+     {
+         pools[i] = &node_storage[i].pool;
+     }
+     (void)pool_numa_init(&numa, pools, num_pools, POOL_INIT_ZEROED, TRUE);  /* .bss, faulted in on its node */
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_numa_alloc(&numa);
+             BENCH_KEEP(block);
+             pool_numa_free(&numa, block);
+         }
+         uint64 ticks = bench_ticks() - start;
+         best = (ticks < best) ? ticks : best;
+     }
+     bench_report("pool_numa_alloc + pool_numa_free", best, BENCH_ITERATIONS);
+     
+     if (node_count < 2U)
+     {
+         printf("%-40s (needs two nodes)\n", "local vs remote placement");
+         return;
+     }
+     
+     {
+         uint32 local = pool_os_numa_current_node();
+         uint32 remote = (local + 1U) % node_count;
+         uint8* buf = (uint8*)aligned_alloc(4096U, BENCH_FILL_BYTES);
+         
+         if (NULL_PTR == buf)
+         {
+             return;
+         }
+         report_per("local node read+write", time_placement(buf, local), BENCH_FILL_BYTES >> 10, "KiB");
+         report_per("remote node read+write", time_placement(buf, remote), BENCH_FILL_BYTES >> 10, "KiB");
+         free(buf);
+     }
+ }
+
+ /**
+  * @brief Object constructor of the cache benchmark: fills the block with a table
+  */
+ static Std_ReturnType bench_table_ctor(void* p_object, void* p_arg)
+ {
+     uint32* table = (uint32*)p_object;
+     uint32 i;
+     
+     (void)p_arg;
+     for (i = 0U; i < (POOL_BLOCK_SIZE / sizeof(uint32)); i++)
+     {
+         table[i] = i * 0x9E3779B9U;
+     }
+     return STD_OK;
+ }
+ 
+ /**
+  * @brief Object destructor of the cache benchmark
+  */
+ static void bench_table_dtor(void* p_object, void* p_arg)
+ {
+     (void)p_arg;
+     BENCH_KEEP(p_object);
+ }
+ 
+ /**
+  * @brief Compare constructing on every allocation against the object cache
+  */
+ static void bench_cache(void)
+ {
+     uint64 best_plain = ~0ULL;
+     uint64 best_cache = ~0ULL;
+     TPool_cache cache;
+     uint32 r;
+     uint32 i;
+     
+     printf("\nObject cache\n");
+     pool_init(&bench_pool);
+     (void)pool_cache_init(&cache, &bench_pool, bench_table_ctor, bench_table_dtor, NULL_PTR);
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_alloc(&bench_pool);
+             (void)bench_table_ctor(block, NULL_PTR);
+             BENCH_KEEP(block);
+             bench_table_dtor(block, NULL_PTR);
+             pool_free(&bench_pool, block);
+         }
+         uint64 ticks = bench_ticks() - start;
+         best_plain = (ticks < best_plain) ? ticks : best_plain;
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* object = pool_cache_alloc(&cache);
+             BENCH_KEEP(object);
+             pool_cache_free(&cache, object);
+         }
+         ticks = bench_ticks() - start;
+         best_cache = (ticks < best_cache) ? ticks : best_cache;
+     }
+     pool_cache_deinit(&cache);
+     
+     bench_report("pool_alloc + ctor + dtor + pool_free", best_plain, BENCH_ITERATIONS);
+     bench_report("pool_cache_alloc + pool_cache_free", best_cache, BENCH_ITERATIONS);
+ }
+ 
+ /**
+  * @brief Measure the cost of the allocation class accounting
+  */
+ static void bench_quota(void)
+ {
+ #if (POOL_QUOTA == STD_ON)
+     uint64 best_plain = ~0ULL;
+     uint64 best_quota = ~0ULL;
+     uint32 r;
+     uint32 i;
+     
+     printf("\nAllocation classes\n");
+     pool_init(&bench_pool);
+     (void)pool_quota_set_class(&bench_pool, 0U, (TPool_index)POOL_NUM_BLOCKS, POOL_PRIORITY_NORMAL);
+     (void)pool_quota_set_reserve(&bench_pool, 1U);
+     
+     for (r = 0U; r < BENCH_REPEATS; r++)
+     {
+         uint64 start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_alloc(&bench_pool);
+             BENCH_KEEP(block);
+             pool_free(&bench_pool, block);
+         }
+         uint64 ticks = bench_ticks() - start;
+         best_plain = (ticks < best_plain) ? ticks : best_plain;
+         
+         start = bench_ticks();
+         for (i = 0U; i < BENCH_ITERATIONS; i++)
+         {
+             void* block = pool_quota_alloc(&bench_pool, 0U);
+             BENCH_KEEP(block);
+             pool_quota_free(&bench_pool, block);
+         }
+         ticks = bench_ticks() - start;
+         best_quota = (ticks < best_quota) ? ticks : best_quota;
+     }
+     
+     bench_report("pool_alloc + pool_free", best_plain, BENCH_ITERATIONS);
+     bench_report("pool_quota_alloc + pool_quota_free", best_quota, BENCH_ITERATIONS);
+ #endif
+ }
@@ -0,0 +1,37 @@
+/**
+ * @file        bench_pool.h
+ * @brief       Benchmark suite interface for memory pool
+ */
+
+ #ifndef BENCH_POOL_H
+ #define BENCH_POOL_H
+ 
+ #include "std_types.h"
+ 
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+ 
+ /**
+  * @brief Run all memory pool benchmarks
+  */
+ void run_all_benchmarks(void);
+ 
+ /**
+  * @brief Print the best per-call cost of a measurement series
+  * @param name       Label of the measurement
+  * @param best_ticks Lowest tick count of the series
+  * @param calls      Number of calls per measurement
+  */
+ void bench_report(const char* name, uint64 best_ticks, uint32 calls);
+ 
+ /**
+  * @brief Run the benchmarks of the C++ interface (bench_cpp.cpp)
+  */
+ void run_cpp_benchmarks(void);
+ 
+ #ifdef __cplusplus
+ }
+ #endif
+ 
+ #endif /* BENCH_POOL_H */
@@ -0,0 +1,52 @@
+/**
+ * @file        bench_timer.h
+ * @brief       Cycle counter for the benchmark suite
+ * @details     Reads the time stamp counter on x86 targets and falls back to a
+ *              nanosecond monotonic clock elsewhere. Only differences between two
+ *              readings are meaningful.
+ */
+
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+#include "std_types.h"
+#include "compiler_abstraction.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+
+/* Unit reported by bench_ticks() */
+#define BENCH_TICK_UNIT "cycles"
+
+/**
+ * @brief Read the cycle counter
+ * @return uint64 Current time stamp counter value
+ */
+LOCAL_INLINE uint64 bench_ticks(void)
+{
+    return (uint64)__rdtsc();
+}
+#else
+#include <time.h>
+
+/* Unit reported by bench_ticks() */
+#define BENCH_TICK_UNIT "ns"
+
+/**
+ * @brief Read the monotonic clock
+ * @return uint64 Current time in nanoseconds
+ */
+LOCAL_INLINE uint64 bench_ticks(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64)ts.tv_sec * 1000000000ULL) + (uint64)ts.tv_nsec;
+}
+#endif
+
+/**
+ * @brief Keep a value alive so the compiler cannot drop the code producing it
+ */
+#define BENCH_KEEP(value) __asm__ __volatile__("" : : "r"(value) : "memory")
+
+#endif /* BENCH_TIMER_H */
@@ -25,4 +25,124 @@
  */
 #define POOL_NUM_BLOCKS        (4U)
 
+/**
+ * @brief   Hardened build switch
+ * @details STD_OFF: pool_free_fast() performs an unchecked, branch-light free.
+ *          STD_ON:  pool_free_fast() performs the full validation of pool_free()
+ *                   and reports violations through the registered violation hook.
+ */
+#ifndef POOL_HARDENED
+#define POOL_HARDENED          (STD_OFF)
+#endif
+
+/**
+ * @brief   Background scrubbing switch
+ * @details STD_ON: freed blocks are queued as dirty and zeroed before they can be
+ *          allocated again, by a background worker started with pool_scrub_start()
+ *          or, if none is running, synchronously by the allocation slow path.
+ *          Requires POSIX threads and POOL_BLOCK_SIZE >= sizeof(void*).
+ */
+#ifndef POOL_SCRUB
+#define POOL_SCRUB             (STD_OFF)
+#endif
+
+/**
+ * @brief   Blocking allocation switch
+ * @details STD_ON: pool_alloc_wait() sleeps on a futex until a block is freed. The
+ *          handle gets a lock, pool_lock()/pool_unlock(), that threads sharing the
+ *          pool use as their external synchronization; a free wakes a sleeper only
+ *          when one is registered.
+ *          STD_OFF: the handle carries no wait state.
+ */
+#ifndef POOL_WAIT
+#define POOL_WAIT              (STD_OFF)
+#endif
+
+/**
+ * @brief   Occupancy watermark switch
+ * @details STD_ON: pool_set_watermarks() can signal an eventfd whenever the number
+ *          of allocated blocks crosses a high or a low watermark. Allocation and
+ *          free pay one compare.
+ *          STD_OFF: the handle carries no watermark state.
+ */
+#ifndef POOL_WATERMARKS
+#define POOL_WATERMARKS        (STD_OFF)
+#endif
+
+/**
+ * @brief   Reclaim on exhaustion switch
+ * @details STD_ON: when the allocation slow path finds no free block it runs the
+ *          reclaim hooks registered with pool_reclaim_register(), asking caches
+ *          built on the pool to give blocks back, and retries once.
+ *          STD_OFF: an exhausted pool returns NULL at once.
+ */
+#ifndef POOL_RECLAIM
+#define POOL_RECLAIM           (STD_OFF)
+#endif
+
+/**
+ * @brief   Allocation classes switch
+ * @details STD_ON: pool_quota_alloc() charges each block to an allocation class with
+ *          its own quota, and a reserve at the end of the pool is left to
+ *          high-priority classes. Costs one byte per block for the owner class.
+ *          STD_OFF: all users of a pool compete for every block.
+ */
+#ifndef POOL_QUOTA
+#define POOL_QUOTA             (STD_OFF)
+#endif
+
+/**
+ * @brief   Page release mode of pool_trim()
+ * @details STD_OFF: free pages are dropped immediately (MADV_DONTNEED).
+ *          STD_ON:  free pages are only marked reclaimable (MADV_FREE), which is
+ *                   cheaper if the pool fills up again before memory runs short.
+ */
+#ifndef POOL_TRIM_LAZY
+#define POOL_TRIM_LAZY         (STD_OFF)
+#endif
+
+/**
+ * @brief   Maximum number of node-local pools behind one NUMA front-end
+ */
+#ifndef POOL_NUMA_MAX_NODES
+#define POOL_NUMA_MAX_NODES    (4U)
+#endif
+
+/**
+ * @brief   Maximum number of overflow chunks behind one pool chain
+ */
+#ifndef POOL_CHAIN_MAX_CHUNKS
+#define POOL_CHAIN_MAX_CHUNKS  (8U)
+#endif
+
+/**
+ * @brief   Maximum number of pools in the global registry
+ * @details The registry lets pool_free_ptr() and pool_owns() find the pool of a
+ *          block from the pointer alone. At most POOL_WORD_BITS pools.
+ */
+#ifndef POOL_REGISTRY_MAX_POOLS
+#define POOL_REGISTRY_MAX_POOLS (16U)
+#endif
+
+/**
+ * @brief   Maximum number of reclaim hooks per pool
+ */
+#ifndef POOL_RECLAIM_MAX_HOOKS
+#define POOL_RECLAIM_MAX_HOOKS (4U)
+#endif
+
+/**
+ * @brief   Number of blocks a reclaim hook is asked to give back at most
+ */
+#ifndef POOL_RECLAIM_BATCH
+#define POOL_RECLAIM_BATCH     (8U)
+#endif
+
+/**
+ * @brief   Maximum number of allocation classes per pool (at most 255)
+ */
+#ifndef POOL_QUOTA_MAX_CLASSES
+#define POOL_QUOTA_MAX_CLASSES (8U)
+#endif
+
 #endif /* POOL_CFG_H */
\ No newline at end of file
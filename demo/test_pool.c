@@ -5,7 +5,26 @@
  */
 
  #include <stdio.h>
+ #include "test_pool.h"
  #include "pool.h"
+ #include "helper_routines.h"
+ #include "pool_scrub.h"
+ #include "pool_numa.h"
+ #include "pool_vpool.h"
+ #include "pool_chain.h"
+ #include "pool_registry.h"
+ #include "pool_define.h"
+ #include "pool_cache.h"
+ #include "pool_wait.h"
+ #include "pool_os.h"
+ #include "pool_watermark.h"
+ #include "pool_reclaim.h"
+ #include "pool_quota.h"
+ 
+ /* Pools of different geometry side by side */
+ POOL_DEFINE(small, 32U, 64U)
+ POOL_DEFINE(wide, 16U, 130U)
+ POOL_DEFINE(large, 512U, 3U)
  
  /* Test case counter */
  static uint32 test_count = 0;
@@ -25,6 +44,33 @@
          } \
      } while(0)
  
+ /**
+  * @brief Helper macro for checks inside loops
+  * @details Records a failure in ok without counting a test, so a loop over
+  *          many cases can report a single TEST_ASSERT(ok) afterwards.
+  */
+ #define TEST_ASSERT_SILENT(ok, condition) \
+     do { \
+         if (!(condition)) { \
+             printf("Check FAILED at %s:%d\n", __FILE__, __LINE__); \
+             (ok) = FALSE; \
+         } \
+     } while(0)
+ 
+ /**
+  * @brief Count and print the result of an assertion made in another test file
+  */
+ void test_record(int passed, const char* file, int line)
+ {
+     test_count++;
+     if (0 != passed) {
+         test_passed++;
+         printf("Test %u: PASSED\n", test_count);
+     } else {
+         printf("Test %u: FAILED at %s:%d\n", test_count, file, line);
+     }
+ }
+ 
  /* Test function declarations */
  static void test_pool_init(void);
  static void test_single_allocation(void);
@@ -32,10 +78,44 @@
  static void test_free_and_reuse(void);
  static void test_null_handling(void);
  static void test_boundary_conditions(void);
+ static void test_fast_free(void);
+ static void test_violation_hook(void);
+ static void test_mem_set(void);
+ static void test_block_kernels(void);
+ static void test_static_init(void);
+ static void test_alloc_zeroed(void);
+ static void test_scrub(void);
+ static void test_trim(void);
+ static void test_prefault(void);
+ static void test_numa(void);
+ static void test_vpool(void);
+ static void test_chain(void);
+ static void test_sizing(void);
+ static void test_registry(void);
+ static void test_pool_define(void);
+ static void test_cache(void);
+ static void test_wait(void);
+ static void test_watermarks(void);
+ static void test_reclaim(void);
+ static void test_quota(void);
  
  /* Test pool handle */
  static TPool_handle test_pool;
  
+ /**
+  * @brief Scrub every block queued by pool_free() so that it can be reused at once
+  * @note  Does nothing with POOL_SCRUB == STD_OFF, where freed blocks are free already
+  */
+ static void scrub_all(TPool_handle* p_handle)
+ {
+ #if (POOL_SCRUB == STD_ON)
+     while (TRUE == pool_scrub_collect(p_handle)) {
+     }
+ #else
+     (void)p_handle;
+ #endif
+ }
+ 
  /**
   * @brief Run all tests
   */
@@ -49,6 +129,27 @@
      test_free_and_reuse();
      test_null_handling();
      test_boundary_conditions();
+     test_fast_free();
+     test_violation_hook();
+     test_mem_set();
+     test_block_kernels();
+     test_static_init();
+     test_alloc_zeroed();
+     test_scrub();
+     test_trim();
+     test_prefault();
+     test_numa();
+     test_vpool();
+     test_chain();
+     test_sizing();
+     test_registry();
+     test_pool_define();
+     test_cache();
+     test_wait();
+     test_watermarks();
+     test_reclaim();
+     test_quota();
+     run_cpp_tests();
      
      printf("\nTest summary: %u/%u tests passed\n", test_passed, test_count);
  }
@@ -87,6 +188,7 @@
     
     /* Free the block */
     pool_free(&test_pool, block);
+    scrub_all(&test_pool);
     
     /* Verify the block is still accessible but marked as free */
     uint32* new_block = (uint32*)pool_alloc(&test_pool);
@@ -204,4 +306,1102 @@
      /* Test with pointer just after pool */
      uint8* after_pool = (uint8*)&test_pool + sizeof(TPool_handle);
      pool_free(&test_pool, after_pool);  /* Should not crash */
- }
\ No newline at end of file
+ }
+
+ /**
+  * @brief Test unchecked fast free
+  */
+ static void test_fast_free(void)
+ {
+     void* block1 = pool_alloc(&test_pool);
+     void* block2 = pool_alloc(&test_pool);
+     
+     TEST_ASSERT(pool_get_free_count(&test_pool) == POOL_NUM_BLOCKS - 2U);
+     
+     pool_free_fast(&test_pool, block1);
+     TEST_ASSERT(pool_get_free_count(&test_pool) == POOL_NUM_BLOCKS - 1U);
+     TEST_ASSERT(pool_alloc(&test_pool) == block1);  /* Freed block is reused */
+     
+     pool_free_fast(&test_pool, block1);
+     pool_free_fast(&test_pool, block2);
+     TEST_ASSERT(pool_get_free_count(&test_pool) == POOL_NUM_BLOCKS);
+ }
+ 
+ /* Last violation reported to the test hook */
+ static uint32 violation_calls = 0;
+ static TPool_violation last_violation;
+ 
+ static void record_violation(const TPool_handle* p_handle, const void* p_block, TPool_violation violation)
+ {
+     (void)p_handle;
+     (void)p_block;
+     violation_calls++;
+     last_violation = violation;
+ }
+ 
+ /**
+  * @brief Test violation reporting of the validated free path
+  */
+ static void test_violation_hook(void)
+ {
+     uint8 dummy;
+     uint8* block = (uint8*)pool_alloc(&test_pool);
+     
+     pool_set_violation_hook(record_violation);
+     
+     pool_free(NULL_PTR, block);
+     TEST_ASSERT(violation_calls == 1U && last_violation == POOL_VIOLATION_NULL_HANDLE);
+     
+     pool_free(&test_pool, NULL_PTR);
+     TEST_ASSERT(violation_calls == 2U && last_violation == POOL_VIOLATION_NULL_BLOCK);
+     
+     pool_free(&test_pool, &dummy);
+     TEST_ASSERT(violation_calls == 3U && last_violation == POOL_VIOLATION_OUT_OF_RANGE);
+     
+     pool_free(&test_pool, block + 1);
+     TEST_ASSERT(violation_calls == 4U && last_violation == POOL_VIOLATION_MISALIGNED);
+     
+     pool_free(&test_pool, block);  /* Valid free is not reported */
+     TEST_ASSERT(violation_calls == 4U);
+     
+     pool_free(&test_pool, block);
+     TEST_ASSERT(violation_calls == 5U && last_violation == POOL_VIOLATION_DOUBLE_FREE);
+     
+ #if (POOL_HARDENED == STD_ON)
+     pool_free_fast(&test_pool, &dummy);
+     TEST_ASSERT(violation_calls == 6U && last_violation == POOL_VIOLATION_OUT_OF_RANGE);
+ #endif
+     
+     pool_set_violation_hook(NULL_PTR);
+     pool_free(&test_pool, block);  /* Silent again */
+     TEST_ASSERT(pool_get_free_count(&test_pool) == POOL_NUM_BLOCKS);
+ }
+ 
+ /**
+  * @brief Check that buf[from, to) holds value and the bytes around it are untouched
+  */
+ static boolean check_fill(const uint8* buf, uint32 size, uint32 from, uint32 to, uint8 value, uint8 guard)
+ {
+     for (uint32 i = 0; i < size; i++) {
+         uint8 expected = (i >= from && i < to) ? value : guard;
+         if (buf[i] != expected) {
+             return FALSE;
+         }
+     }
+     return TRUE;
+ }
+ 
+ /**
+  * @brief Test vectorized and non-temporal memory fill
+  */
+ static void test_mem_set(void)
+ {
+     static uint8 buf[512];
+     boolean all_ok = TRUE;
+     
+     TEST_ASSERT(mem_set(NULL_PTR, 0, 16U) == NULL_PTR);
+     TEST_ASSERT(mem_set_nt(NULL_PTR, 0, 16U) == NULL_PTR);
+     
+     /* Every head alignment combined with lengths around the chunk sizes */
+     for (uint32 offset = 0; offset < 16U; offset++) {
+         for (uint32 len = 0; len < 200U; len += 7U) {
+             for (uint32 i = 0; i < sizeof(buf); i++) {
+                 buf[i] = 0x5A;
+             }
+             TEST_ASSERT_SILENT(all_ok, mem_set(&buf[offset], 0xA5, len) == &buf[offset]);
+             TEST_ASSERT_SILENT(all_ok, check_fill(buf, sizeof(buf), offset, offset + len, 0xA5, 0x5A));
+             
+             mem_set_nt(&buf[offset], 0x5A, len);
+             TEST_ASSERT_SILENT(all_ok, check_fill(buf, sizeof(buf), 0, 0, 0, 0x5A));
+         }
+     }
+     TEST_ASSERT(all_ok);
+ }
+ 
+ /**
+  * @brief Test fixed-size block zero and copy kernels
+  */
+ static void test_block_kernels(void)
+ {
+     uint8* src = (uint8*)pool_alloc(&test_pool);
+     uint8* dst = (uint8*)pool_alloc(&test_pool);
+     boolean all_ok = TRUE;
+     
+     for (uint32 i = 0; i < POOL_BLOCK_SIZE; i++) {
+         src[i] = (uint8)(i + 1U);
+         dst[i] = 0xFF;
+     }
+     
+     pool_block_copy(dst, src);
+     for (uint32 i = 0; i < POOL_BLOCK_SIZE; i++) {
+         TEST_ASSERT_SILENT(all_ok, dst[i] == (uint8)(i + 1U));
+     }
+     TEST_ASSERT(all_ok);
+     
+     pool_block_zero(dst);
+     for (uint32 i = 0; i < POOL_BLOCK_SIZE; i++) {
+         TEST_ASSERT_SILENT(all_ok, dst[i] == 0U);
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(src[0] == 1U);  /* Neighbour block untouched */
+     
+     pool_free(&test_pool, src);
+     pool_free(&test_pool, dst);
+ }
+ 
+ /* Pool that is never passed to pool_init() */
+ static TPool_handle static_pool = POOL_STATIC_INIT;
+ 
+ /**
+  * @brief Test constant initialization and metadata-only reset
+  */
+ static void test_static_init(void)
+ {
+     /* Usable straight from static storage */
+     TEST_ASSERT(pool_get_free_count(&static_pool) == POOL_NUM_BLOCKS);
+     uint32* block = (uint32*)pool_alloc(&static_pool);
+     TEST_ASSERT(block == (uint32*)static_pool.memory);
+     *block = 0xCAFEF00D;
+     
+     /* Metadata reset frees every block but leaves the memory area as is */
+     pool_init_ex(&static_pool, POOL_INIT_METADATA);
+     TEST_ASSERT(pool_get_free_count(&static_pool) == POOL_NUM_BLOCKS);
+     TEST_ASSERT(*block == 0xCAFEF00D);
+     TEST_ASSERT(pool_alloc(&static_pool) == block);
+     
+     /* Full reset clears it */
+     pool_init_ex(&static_pool, POOL_INIT_FULL);
+     TEST_ASSERT(*block == 0U);
+     pool_init_ex(NULL_PTR, POOL_INIT_METADATA);  /* Should not crash */
+ }
+ 
+ /**
+  * @brief Test zeroed allocation and the known-zero watermark
+  */
+ static void test_alloc_zeroed(void)
+ {
+     TEST_ASSERT(pool_alloc_zeroed(NULL_PTR) == NULL_PTR);
+     
+     /* Dirty the first block */
+     pool_init(&static_pool);
+     uint32* block = (uint32*)pool_alloc(&static_pool);
+     *block = 0x12345678;
+     pool_free(&static_pool, block);
+     scrub_all(&static_pool);
+     
+     /* Still known zero from pool_init(): block 1 is untouched */
+     pool_alloc(&static_pool);
+     uint32* fresh = (uint32*)pool_alloc_zeroed(&static_pool);
+     TEST_ASSERT(fresh == (uint32*)&static_pool.memory[POOL_BLOCK_SIZE]);
+     TEST_ASSERT(*fresh == 0U);
+     
+     /* A reused block is cleared */
+     pool_init_ex(&static_pool, POOL_INIT_ZEROED);
+     *block = 0x12345678;  /* Lie about the memory being zero ... */
+     TEST_ASSERT(pool_alloc_zeroed(&static_pool) == block);
+     TEST_ASSERT(*block == 0x12345678);  /* ... so the block is not cleared */
+     *block = 0xFFFFFFFF;
+     pool_free(&static_pool, block);
+     scrub_all(&static_pool);
+     TEST_ASSERT(pool_alloc_zeroed(&static_pool) == block);
+     TEST_ASSERT(*block == 0U);  /* Handed out before, so it is cleared */
+     
+     /* Unknown memory contents after a metadata reset: every block is cleared */
+     *block = 0xFFFFFFFF;
+     pool_init_ex(&static_pool, POOL_INIT_METADATA);
+     TEST_ASSERT(pool_alloc_zeroed(&static_pool) == block);
+     TEST_ASSERT(*block == 0U);
+ }
+ 
+ /**
+  * @brief Test background and synchronous scrubbing of freed blocks
+  */
+ static void test_scrub(void)
+ {
+ #if (POOL_SCRUB == STD_ON)
+     TPool_stats stats;
+     uint32* blocks[POOL_NUM_BLOCKS];
+     uint32 spins;
+     
+     /* Without a worker: exhaustion scrubs a dirty block in place */
+     pool_init(&static_pool);
+     for (uint32 i = 0; i < POOL_NUM_BLOCKS; i++) {
+         blocks[i] = (uint32*)pool_alloc(&static_pool);
+         *blocks[i] = 0xDEADBEEF;
+     }
+     pool_free(&static_pool, blocks[0]);
+     pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.dirty_count == 1U && stats.free_count == 1U);
+     pool_free(&static_pool, blocks[0]);  /* Double free of a queued block is rejected */
+     pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.dirty_count == 1U);
+     TEST_ASSERT(pool_alloc(&static_pool) == blocks[0]);
+     TEST_ASSERT(*blocks[0] == 0U);
+     
+     /* With a worker: freed blocks come back clean */
+     TEST_ASSERT(pool_scrub_start(&static_pool) == STD_OK);
+     TEST_ASSERT(pool_scrub_start(&static_pool) == STD_NOT_OK);
+     for (uint32 i = 0; i < POOL_NUM_BLOCKS; i++) {
+         *blocks[i] = 0xDEADBEEF;
+         pool_free(&static_pool, blocks[i]);
+     }
+     for (spins = 0U; spins < 5000U; spins++) {  /* Up to 5 s on a loaded machine */
+         uint32 idle = 0U;
+         pool_get_stats(&static_pool, &stats);
+         if (stats.clean_count == POOL_NUM_BLOCKS) {  /* The worker counts dirty down first */
+             break;
+         }
+         (void)pool_os_futex_wait(&idle, 0U, 1000000ULL);  /* Nobody wakes it: a 1 ms sleep */
+     }
+     TEST_ASSERT(stats.dirty_count == 0U && stats.clean_count == POOL_NUM_BLOCKS);
+     pool_scrub_stop(&static_pool);
+     
+     for (uint32 i = 0; i < POOL_NUM_BLOCKS; i++) {
+         TEST_ASSERT(*(uint32*)pool_alloc(&static_pool) == 0U);
+     }
+     pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.clean_count == 0U && stats.used_count == POOL_NUM_BLOCKS);
+ #else
+     TEST_ASSERT(pool_scrub_start(&static_pool) == STD_NOT_OK);
+ #endif
+ }
+ 
+ /**
+  * @brief Test release of free page runs
+  */
+ static void test_trim(void)
+ {
+     TEST_ASSERT(pool_trim(NULL_PTR) == 0U);
+     
+     pool_init(&static_pool);
+     uint32* first = (uint32*)pool_alloc(&static_pool);
+     *first = 0xFEEDFACE;
+     
+     /* Never more than the free part of the memory area */
+     uint32 released = pool_trim(&static_pool);
+     TEST_ASSERT(released <= ((POOL_NUM_BLOCKS - 1U) * POOL_BLOCK_SIZE));
+ #if ((POOL_NUM_BLOCKS * POOL_BLOCK_SIZE) >= (4U * 4096U))
+     TEST_ASSERT(released > 0U);
+ #endif
+     TEST_ASSERT(*first == 0xFEEDFACE);  /* Allocated block survives */
+     TEST_ASSERT(pool_get_free_count(&static_pool) == POOL_NUM_BLOCKS - 1U);
+     
+     /* Freed blocks stay usable after their pages were released */
+     uint32* second = (uint32*)pool_alloc(&static_pool);
+     *second = 0x0BADF00D;
+     TEST_ASSERT(*second == 0x0BADF00D);
+     
+     /* Automatic trim on reaching the threshold, from both free paths */
+     TPool_stats stats;
+     (void)pool_get_stats(&static_pool, &stats);
+     uint32 runs = stats.trim_runs;
+     TEST_ASSERT(runs >= 1U);  /* The explicit call above */
+     pool_set_trim_threshold(&static_pool, POOL_NUM_BLOCKS);
+     pool_free(&static_pool, second);
+     (void)pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.trim_runs == runs);  /* Below the threshold */
+     pool_free(&static_pool, first);
+     TEST_ASSERT(pool_get_free_count(&static_pool) == POOL_NUM_BLOCKS);
+     (void)pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.trim_runs == (runs + 1U));
+     pool_free_fast(&static_pool, pool_alloc(&static_pool));
+     (void)pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.trim_runs == (runs + 2U));
+     
+     /* A zero threshold disables it again */
+     pool_set_trim_threshold(&static_pool, 0U);
+     pool_free(&static_pool, pool_alloc(&static_pool));
+     (void)pool_get_stats(&static_pool, &stats);
+     TEST_ASSERT(stats.trim_runs == (runs + 2U));
+ }
+ 
+ /**
+  * @brief Test prefaulting of the memory area
+  */
+ static void test_prefault(void)
+ {
+     TEST_ASSERT(pool_prefault(NULL_PTR, FALSE, 1U) == STD_NOT_OK);
+     
+     pool_init(&static_pool);
+     uint32* block = (uint32*)pool_alloc(&static_pool);
+     *block = 0xA11CE5ED;
+     
+     TEST_ASSERT(pool_prefault(&static_pool, FALSE, 4U) == STD_OK);
+     TEST_ASSERT(*block == 0xA11CE5ED);  /* Contents are preserved */
+     (void)pool_prefault(&static_pool, TRUE, 1U);  /* May exceed RLIMIT_MEMLOCK */
+     TEST_ASSERT(*block == 0xA11CE5ED);
+     
+     pool_free(&static_pool, block);
+ }
+ 
+ /**
+  * @brief Test the NUMA front-end (works on single-node machines too)
+  */
+ static void test_numa(void)
+ {
+     static struct { TPool_handle pool ATTR_ALIGNED(4096); } node_storage[2];  /* One page run per node */
+     TPool_handle* const pools[2] = { &node_storage[0].pool, &node_storage[1].pool };
+     static uint8 bind_area[2U * 4096U] ATTR_ALIGNED(4096);
+     TPool_numa numa;
+     void* blocks[2U * POOL_NUM_BLOCKS];
+     
+     /* Pages shared with neighbouring data are never bound */
+     if (4096U == pool_os_page_size()) {
+         TEST_ASSERT(pool_os_numa_bind(&bind_area[1], sizeof(bind_area) - 2U, 0U) == STD_NOT_OK);
+     }
+     
+     TEST_ASSERT(pool_numa_init(NULL_PTR, pools, 2U, POOL_INIT_FULL, FALSE) == STD_NOT_OK);
+     TEST_ASSERT(pool_numa_init(&numa, pools, 0U, POOL_INIT_FULL, FALSE) == STD_NOT_OK);
+     TEST_ASSERT(pool_numa_init(&numa, pools, POOL_NUMA_MAX_NODES + 1U, POOL_INIT_FULL, FALSE) == STD_NOT_OK);
+     TEST_ASSERT(pool_numa_init(&numa, pools, 2U, POOL_INIT_ZEROED, TRUE) == STD_OK);  /* Untouched .bss */
+     
+     /* Every block of both pools is reachable through the front-end */
+     for (uint32 i = 0; i < 2U * POOL_NUM_BLOCKS; i++) {
+         blocks[i] = pool_numa_alloc(&numa);
+         TEST_ASSERT(blocks[i] != NULL_PTR);
+     }
+     TEST_ASSERT(pool_numa_alloc(&numa) == NULL_PTR);
+     TEST_ASSERT(pool_get_free_count(pools[0]) == 0U);
+     TEST_ASSERT(pool_get_free_count(pools[1]) == 0U);
+     
+     /* Frees find the owning pool */
+     for (uint32 i = 0; i < 2U * POOL_NUM_BLOCKS; i++) {
+         pool_numa_free(&numa, blocks[i]);
+     }
+     TEST_ASSERT(pool_get_free_count(pools[0]) == POOL_NUM_BLOCKS);
+     TEST_ASSERT(pool_get_free_count(pools[1]) == POOL_NUM_BLOCKS);
+     pool_numa_free(&numa, &numa);  /* Foreign pointer is ignored */
+ }
+ 
+ /**
+  * @brief Test the reserve-then-commit virtual pool
+  */
+ static void test_vpool(void)
+ {
+     TPool_vpool vpool;
+     const uintptr chunk = 64U * 1024U;
+     const uint32 per_chunk = (uint32)(chunk / POOL_BLOCK_SIZE);
+     const uint32 max_blocks = 4U * per_chunk;
+     uint8* first;
+     uint8* block = NULL_PTR;
+     boolean all_ok = TRUE;
+     
+     TEST_ASSERT(pool_vpool_create(NULL_PTR, 16U, chunk) == STD_NOT_OK);
+     TEST_ASSERT(pool_vpool_create(&vpool, 0U, chunk) == STD_NOT_OK);
+     TEST_ASSERT(pool_vpool_create(&vpool, max_blocks, chunk) == STD_OK);
+     TEST_ASSERT(pool_vpool_get_committed(&vpool) == 0U);
+     TEST_ASSERT(pool_vpool_get_free_count(&vpool) == max_blocks);
+     
+     /* The first chunk is committed by the first allocation */
+     first = (uint8*)pool_vpool_alloc(&vpool);
+     TEST_ASSERT(first != NULL_PTR);
+     TEST_ASSERT(pool_vpool_get_committed(&vpool) == chunk);
+     
+     /* Filling the chunk does not commit more; one block past it does */
+     for (uint32 i = 1U; i < per_chunk; i++) {
+         block = (uint8*)pool_vpool_alloc(&vpool);
+         TEST_ASSERT_SILENT(all_ok, block == first + (i * POOL_BLOCK_SIZE));
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(pool_vpool_get_committed(&vpool) == chunk);
+     *block = 0x42;
+     block = (uint8*)pool_vpool_alloc(&vpool);
+     TEST_ASSERT(block == first + chunk);  /* Stable addresses across growth */
+     TEST_ASSERT(pool_vpool_get_committed(&vpool) == 2U * chunk);
+     TEST_ASSERT(first[chunk - POOL_BLOCK_SIZE] == 0x42);
+     
+     /* Range check still rejects uncommitted and foreign pointers */
+     pool_vpool_free(&vpool, first + (3U * chunk));
+     pool_vpool_free(&vpool, first + 1);
+     pool_vpool_free(&vpool, &vpool);
+     TEST_ASSERT(pool_vpool_get_free_count(&vpool) == max_blocks - per_chunk - 1U);
+     
+     /* Freed blocks are reused before the pool grows again */
+     pool_vpool_free(&vpool, first);
+     pool_vpool_free(&vpool, first);  /* Double free is ignored */
+     TEST_ASSERT(pool_vpool_get_free_count(&vpool) == max_blocks - per_chunk);
+     TEST_ASSERT(pool_vpool_alloc(&vpool) == first);
+     
+     /* Exhaustion at the reserved maximum */
+     while (NULL_PTR != pool_vpool_alloc(&vpool)) {
+     }
+     TEST_ASSERT(pool_vpool_get_free_count(&vpool) == 0U);
+     TEST_ASSERT(pool_vpool_get_committed(&vpool) == 4U * chunk);
+     
+     pool_vpool_destroy(&vpool);
+     TEST_ASSERT(pool_vpool_alloc(&vpool) == NULL_PTR);
+     
+     /* A chunk of ~0 commits the whole reservation at once instead of overflowing */
+     TEST_ASSERT(pool_vpool_create(&vpool, max_blocks, ~(uintptr)0U) == STD_OK);
+     first = (uint8*)pool_vpool_alloc(&vpool);
+     TEST_ASSERT(first != NULL_PTR);
+     TEST_ASSERT(pool_vpool_get_committed(&vpool) == 4U * chunk);
+     all_ok = TRUE;
+     for (uint32 i = 1U; i < (per_chunk + 1U); i++) {
+         TEST_ASSERT_SILENT(all_ok, pool_vpool_alloc(&vpool) == first + (i * POOL_BLOCK_SIZE));
+     }
+     TEST_ASSERT(all_ok);
+     while (NULL_PTR != pool_vpool_alloc(&vpool)) {
+     }
+     TEST_ASSERT(pool_vpool_get_free_count(&vpool) == 0U);
+     pool_vpool_destroy(&vpool);
+ }
+
+ /**
+  * @brief Test overflow chunks of a pool chain from every source
+  */
+ static void test_chain(void)
+ {
+     static TPool_handle primary;
+     static TPool_handle reserve[2];
+     const TPool_chain_source sources[] = {
+         POOL_CHAIN_SOURCE_MALLOC, POOL_CHAIN_SOURCE_MMAP, POOL_CHAIN_SOURCE_STATIC
+     };
+     TPool_chain chain;
+     void* blocks[3U * POOL_NUM_BLOCKS];
+     boolean all_ok;
+     uint32 i;
+     uint32 s;
+     
+     TEST_ASSERT(pool_chain_init(NULL_PTR, &primary, POOL_CHAIN_SOURCE_MALLOC, NULL_PTR, 0U, 0U) == STD_NOT_OK);
+     TEST_ASSERT(pool_chain_init(&chain, NULL_PTR, POOL_CHAIN_SOURCE_MALLOC, NULL_PTR, 0U, 0U) == STD_NOT_OK);
+     TEST_ASSERT(pool_chain_init(&chain, &primary, POOL_CHAIN_SOURCE_STATIC, NULL_PTR, 2U, 0U) == STD_NOT_OK);
+     
+     for (s = 0U; s < (sizeof(sources) / sizeof(sources[0])); s++) {
+         pool_init(&primary);
+         TEST_ASSERT(pool_chain_init(&chain, &primary, sources[s], reserve, 2U, 0U) == STD_OK);
+         
+         /* The primary pool is used first, then chunks are added on demand */
+         all_ok = TRUE;
+         for (i = 0U; i < (3U * POOL_NUM_BLOCKS); i++) {
+             blocks[i] = pool_chain_alloc(&chain);
+             TEST_ASSERT_SILENT(all_ok, blocks[i] != NULL_PTR);
+         }
+         TEST_ASSERT(all_ok);
+         TEST_ASSERT(pool_get_free_count(&primary) == 0U);
+         TEST_ASSERT(chain.num_chunks == 2U);
+         TEST_ASSERT((chain.num_chunks < 2U) || (chain.chunks[0]->memory < chain.chunks[1]->memory));
+         TEST_ASSERT((chain.chunks[0]->trim_free == 0U) && (chain.chunks[1]->trim_free == 0U));  /* No stale state */
+         
+         /* Overflow blocks are usable memory of their own */
+         for (i = 0U; i < (3U * POOL_NUM_BLOCKS); i++) {
+             mem_set(blocks[i], (uint8)i, POOL_BLOCK_SIZE);
+         }
+         all_ok = TRUE;
+         for (i = 0U; i < (3U * POOL_NUM_BLOCKS); i++) {
+             TEST_ASSERT_SILENT(all_ok, ((uint8*)blocks[i])[POOL_BLOCK_SIZE - 1U] == (uint8)i);
+         }
+         TEST_ASSERT(all_ok);
+         
+         /* The static reserve runs out after its two handles */
+         if (POOL_CHAIN_SOURCE_STATIC == sources[s]) {
+             TEST_ASSERT(pool_chain_alloc(&chain) == NULL_PTR);
+         }
+         
+         /* Foreign pointers are ignored; frees reach the owning pool */
+         pool_chain_free(&chain, &chain);
+         pool_chain_free(&chain, blocks[0]);
+         TEST_ASSERT(pool_get_free_count(&primary) == 1U);
+         TEST_ASSERT(pool_chain_alloc(&chain) == blocks[0]);
+         
+         /* A chunk is released as soon as it empties with no cooldown */
+         for (i = POOL_NUM_BLOCKS; i < (2U * POOL_NUM_BLOCKS); i++) {
+             pool_chain_free(&chain, blocks[i]);
+         }
+         TEST_ASSERT(chain.num_chunks == 1U);
+         
+         pool_chain_deinit(&chain);
+         TEST_ASSERT(chain.num_chunks == 0U);
+     }
+     
+     /* With a long cooldown an empty chunk is kept and reused */
+     pool_init(&primary);
+     TEST_ASSERT(pool_chain_init(&chain, &primary, POOL_CHAIN_SOURCE_STATIC, reserve, 2U, ~0ULL) == STD_OK);
+     for (i = 0U; i < (POOL_NUM_BLOCKS + 1U); i++) {
+         blocks[i] = pool_chain_alloc(&chain);
+     }
+     pool_chain_free(&chain, blocks[POOL_NUM_BLOCKS]);
+     TEST_ASSERT(chain.num_chunks == 1U);
+     scrub_all(chain.chunks[0]);
+     TEST_ASSERT(pool_chain_release_idle(&chain) == 0U);
+     TEST_ASSERT(pool_chain_alloc(&chain) == blocks[POOL_NUM_BLOCKS]);
+     TEST_ASSERT(chain.num_chunks == 1U);
+     pool_chain_deinit(&chain);
+     TEST_ASSERT(chain.reserve_taken[0] == FALSE);
+ }
+
+ /**
+  * @brief Test that index and size types fit the configuration
+  */
+ static void test_sizing(void)
+ {
+     TPool_vpool vpool;
+     
+     TEST_ASSERT(sizeof(static_pool.memory) == POOL_MEMORY_SIZE);
+     TEST_ASSERT((TPool_index)POOL_NUM_BLOCKS == POOL_NUM_BLOCKS);
+     TEST_ASSERT((TPool_size)POOL_MEMORY_SIZE == POOL_MEMORY_SIZE);
+ #if (POOL_NUM_BLOCKS <= 0xFFU)
+     TEST_ASSERT(sizeof(TPool_index) == 1U);  /* Compact metadata for small pools */
+ #endif
+     
+ #if defined(__LP64__)
+     /* More than 2^32 blocks: the reservation is address space only */
+     if (STD_OK == pool_vpool_create(&vpool, 0x100000040ULL, 64U * 1024U)) {
+         TEST_ASSERT(pool_vpool_get_free_count(&vpool) == 0x100000040ULL);
+         TEST_ASSERT(pool_vpool_alloc(&vpool) == vpool.memory);
+         TEST_ASSERT(pool_vpool_get_free_count(&vpool) == 0x10000003FULL);
+         pool_vpool_destroy(&vpool);
+     }
+ #endif
+     TEST_ASSERT(pool_vpool_create(&vpool, ~(uintptr)0U, 64U * 1024U) == STD_NOT_OK);
+ }
+
+ /**
+  * @brief Test the global registry and handle-less free
+  */
+ static void test_registry(void)
+ {
+     static TPool_handle pools[POOL_REGISTRY_MAX_POOLS];
+     static TPool_handle extra;
+     uint8* blocks[POOL_REGISTRY_MAX_POOLS];
+     boolean all_ok = TRUE;
+     uint32 i;
+     
+     TEST_ASSERT(pool_register(NULL_PTR) == STD_NOT_OK);
+     TEST_ASSERT(pool_owns(&pools[0].memory[0]) == NULL_PTR);  /* Empty registry */
+     
+     /* Adjacent handles share granules */
+     for (i = 0U; i < POOL_REGISTRY_MAX_POOLS; i++) {
+         pool_init(&pools[i]);
+         TEST_ASSERT_SILENT(all_ok, pool_register(&pools[i]) == STD_OK);
+         blocks[i] = (uint8*)pool_alloc(&pools[i]);
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(pool_register(&pools[0]) == STD_NOT_OK);  /* Already registered */
+     TEST_ASSERT(pool_register(&extra) == STD_NOT_OK);     /* Registry full */
+     
+     /* Every byte of a memory area maps to its pool, nothing outside does */
+     all_ok = TRUE;
+     for (i = 0U; i < POOL_REGISTRY_MAX_POOLS; i++) {
+         TEST_ASSERT_SILENT(all_ok, pool_owns(blocks[i]) == &pools[i]);
+         TEST_ASSERT_SILENT(all_ok, pool_owns(&pools[i].memory[sizeof(pools[i].memory) - 1U]) == &pools[i]);
+         TEST_ASSERT_SILENT(all_ok, pool_owns(pools[i].bitmap) == NULL_PTR);
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(pool_owns(&extra) == NULL_PTR);
+     TEST_ASSERT(pool_owns(NULL_PTR) == NULL_PTR);
+     
+     /* Handle-less free goes through the validated free of the owner */
+     pool_free_ptr(blocks[1] + 1);  /* Misaligned */
+     pool_free_ptr(&extra);         /* Foreign */
+     pool_free_ptr(NULL_PTR);
+     TEST_ASSERT(pool_get_free_count(&pools[1]) == POOL_NUM_BLOCKS - 1U);
+     pool_free_ptr(blocks[1]);
+     TEST_ASSERT(pool_get_free_count(&pools[1]) == POOL_NUM_BLOCKS);
+     
+     /* Unregistered pools are no longer found; their slot is reusable */
+     pool_unregister(&pools[1]);
+     pool_unregister(&pools[1]);
+     TEST_ASSERT(pool_owns(blocks[1]) == NULL_PTR);
+     TEST_ASSERT(pool_owns(blocks[2]) == &pools[2]);
+     TEST_ASSERT(pool_register(&extra) == STD_OK);
+     TEST_ASSERT(pool_owns(&extra.memory[0]) == &extra);
+     
+     pool_unregister(&extra);
+     for (i = 0U; i < POOL_REGISTRY_MAX_POOLS; i++) {
+         pool_unregister(&pools[i]);
+     }
+     TEST_ASSERT(pool_owns(blocks[0]) == NULL_PTR);
+ }
+
+ /**
+  * @brief Test pools generated by POOL_DEFINE()
+  */
+ static void test_pool_define(void)
+ {
+     static TPool_small small_pool;  /* Zero storage is an empty pool */
+     static TPool_wide wide_pool;
+     static TPool_large large_pool;
+     uint8* blocks[130];
+     boolean all_ok = TRUE;
+     uint32 i;
+     
+     TEST_ASSERT(sizeof(small_pool.memory) == (32U * 64U));
+     TEST_ASSERT(sizeof(wide_pool.bitmap) == (((130U + POOL_WORD_BITS) - 1U) / POOL_WORD_BITS) * sizeof(TPool_word));
+     TEST_ASSERT(small_free_count(&small_pool) == 64U);
+     TEST_ASSERT(small_alloc(&small_pool) == &small_pool.memory[0]);
+     TEST_ASSERT(small_free_count(&small_pool) == 63U);
+     
+     /* Blocks are handed out in order across bitmap words, then exhaustion */
+     wide_init(&wide_pool);
+     for (i = 0U; i < 130U; i++) {
+         blocks[i] = (uint8*)wide_alloc(&wide_pool);
+         TEST_ASSERT_SILENT(all_ok, blocks[i] == &wide_pool.memory[i * 16U]);
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(wide_alloc(&wide_pool) == NULL_PTR);
+     TEST_ASSERT(wide_free_count(&wide_pool) == 0U);
+     
+     /* Invalid frees are ignored */
+     wide_free(&wide_pool, NULL_PTR);
+     wide_free(&wide_pool, blocks[5] + 1);
+     wide_free(&wide_pool, &small_pool.memory[0]);
+     TEST_ASSERT(wide_free_count(&wide_pool) == 0U);
+     
+     /* The lowest free block is reused first */
+     wide_free(&wide_pool, blocks[129]);
+     wide_free(&wide_pool, blocks[70]);
+     wide_free(&wide_pool, blocks[70]);  /* Double free is ignored */
+     TEST_ASSERT(wide_free_count(&wide_pool) == 2U);
+     TEST_ASSERT(wide_alloc(&wide_pool) == blocks[70]);
+     TEST_ASSERT(wide_alloc(&wide_pool) == blocks[129]);
+     
+     /* Large blocks are independent of the global configuration */
+     large_init(&large_pool);
+     TEST_ASSERT(large_alloc(&large_pool) == &large_pool.memory[0]);
+     TEST_ASSERT(large_alloc(&large_pool) == &large_pool.memory[512]);
+     TEST_ASSERT(large_alloc(&large_pool) == &large_pool.memory[1024]);
+     TEST_ASSERT(large_alloc(&large_pool) == NULL_PTR);
+     large_free(&large_pool, &large_pool.memory[512]);
+     TEST_ASSERT(large_free_count(&large_pool) == 1U);
+ }
+
+ /**
+  * @brief Object of the cache test: expensive state set up by the constructor
+  */
+ typedef struct {
+     uint32 magic;       /* Set by the constructor, cleared by the destructor */
+     uint32 generation;  /* Bumped by the application on every use */
+ } TCache_object;
+
+ /**
+  * @brief Constructor and destructor counters of the cache test
+  */
+ typedef struct {
+     uint32 ctor_calls;
+     uint32 dtor_calls;
+     boolean fail_ctor;
+ } TCache_counters;
+
+ #define CACHE_MAGIC 0xCAC4E0B1U
+
+ static Std_ReturnType cache_ctor(void* p_object, void* p_arg)
+ {
+     TCache_counters* counters = (TCache_counters*)p_arg;
+     TCache_object* object = (TCache_object*)p_object;
+
+     if (counters->fail_ctor) {
+         return STD_NOT_OK;
+     }
+     counters->ctor_calls++;
+     object->magic = CACHE_MAGIC;
+     object->generation = 0U;
+     return STD_OK;
+ }
+
+ static void cache_dtor(void* p_object, void* p_arg)
+ {
+     TCache_counters* counters = (TCache_counters*)p_arg;
+
+     counters->dtor_calls++;
+     ((TCache_object*)p_object)->magic = 0U;
+ }
+
+ /**
+  * @brief Test the object cache: construction once per block, destruction on reap
+  */
+ static void test_cache(void)
+ {
+     static TPool_handle cache_pool;
+     TCache_counters counters = { 0U, 0U, FALSE };
+     TPool_cache cache;
+     TCache_object* objects[POOL_NUM_BLOCKS];
+     TCache_object* object;
+     boolean all_ok = TRUE;
+     uint32 i;
+
+     pool_init(&cache_pool);
+     TEST_ASSERT(pool_cache_init(NULL_PTR, &cache_pool, cache_ctor, cache_dtor, &counters) == STD_NOT_OK);
+     TEST_ASSERT(pool_cache_init(&cache, NULL_PTR, cache_ctor, cache_dtor, &counters) == STD_NOT_OK);
+     TEST_ASSERT(pool_cache_init(&cache, &cache_pool, cache_ctor, cache_dtor, &counters) == STD_OK);
+
+     /* A failing constructor fails the allocation and leaves the pool untouched */
+     counters.fail_ctor = TRUE;
+     TEST_ASSERT(pool_cache_alloc(&cache) == NULL_PTR);
+     TEST_ASSERT(pool_get_free_count(&cache_pool) == POOL_NUM_BLOCKS);
+     counters.fail_ctor = FALSE;
+     scrub_all(&cache_pool);
+
+     /* Each block is constructed when it enters the cache */
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         objects[i] = (TCache_object*)pool_cache_alloc(&cache);
+         TEST_ASSERT_SILENT(all_ok, (objects[i] != NULL_PTR) && (objects[i]->magic == CACHE_MAGIC));
+         objects[i]->generation++;
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(counters.ctor_calls == POOL_NUM_BLOCKS);
+     TEST_ASSERT(pool_cache_alloc(&cache) == NULL_PTR);
+
+     /* Free and alloc recycle constructed objects without callbacks */
+     pool_cache_free(&cache, objects[1]);
+     pool_cache_free(&cache, objects[0]);
+     pool_cache_free(&cache, objects[0]);          /* Already cached */
+     pool_cache_free(&cache, (uint8*)objects[0] + 1);  /* Misaligned */
+     pool_cache_free(&cache, &cache);              /* Foreign */
+     TEST_ASSERT(pool_cache_get_cached_count(&cache) == 2U);
+     TEST_ASSERT(pool_get_free_count(&cache_pool) == 0U);  /* Cached blocks stay allocated */
+     object = (TCache_object*)pool_cache_alloc(&cache);
+     TEST_ASSERT(object == objects[0]);            /* Lowest cached object first */
+     TEST_ASSERT((object->magic == CACHE_MAGIC) && (object->generation == 1U));
+     TEST_ASSERT(pool_cache_alloc(&cache) == objects[1]);
+     TEST_ASSERT((counters.ctor_calls == POOL_NUM_BLOCKS) && (counters.dtor_calls == 0U));
+
+     /* Reaping destroys the cached objects beyond keep and frees their blocks */
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         pool_cache_free(&cache, objects[i]);
+     }
+     TEST_ASSERT(pool_cache_reap(&cache, 1U) == (POOL_NUM_BLOCKS - 1U));
+     TEST_ASSERT(counters.dtor_calls == (POOL_NUM_BLOCKS - 1U));
+     TEST_ASSERT(pool_get_free_count(&cache_pool) == (POOL_NUM_BLOCKS - 1U));
+     TEST_ASSERT(pool_cache_alloc(&cache) == objects[0]);  /* The kept object is the lowest one */
+     pool_cache_free(&cache, objects[0]);
+     scrub_all(&cache_pool);
+
+     /* Blocks that left the cache are constructed again on the next miss */
+     TEST_ASSERT(pool_cache_alloc(&cache) == objects[0]);
+     object = (TCache_object*)pool_cache_alloc(&cache);
+     TEST_ASSERT((object == objects[1]) && (object->generation == 0U));
+     TEST_ASSERT(counters.ctor_calls == (POOL_NUM_BLOCKS + 1U));
+     pool_cache_free(&cache, objects[0]);
+     pool_cache_free(&cache, object);
+
+     pool_cache_deinit(&cache);
+     TEST_ASSERT(counters.dtor_calls == (POOL_NUM_BLOCKS + 1U));
+     TEST_ASSERT(pool_get_free_count(&cache_pool) == POOL_NUM_BLOCKS);
+     TEST_ASSERT(pool_cache_alloc(&cache) == NULL_PTR);
+ }
+
+ #if (POOL_WAIT == STD_ON)
+ #include <pthread.h>
+ 
+ /**
+  * @brief Block freed by the helper thread of the wait test after a delay
+  */
+ static void* wait_block;
+ 
+ static void* wait_free_later(void* p_arg)
+ {
+     TPool_handle* pool = (TPool_handle*)p_arg;
+     uint32 idle = 0U;
+     
+     /* Wait until the main thread sleeps in pool_alloc_wait() */
+     pool_lock(pool);
+     while (0U == pool->wait.waiters) {
+         pool_unlock(pool);
+         (void)pool_os_futex_wait(&idle, 0U, 1000000ULL);  /* Nobody wakes it: a 1 ms sleep */
+         pool_lock(pool);
+     }
+     pool_free(pool, wait_block);
+     pool_unlock(pool);
+     return NULL_PTR;
+ }
+ #endif
+ 
+ /**
+  * @brief Test blocking allocation with timeouts and wakeups from another thread
+  */
+ static void test_wait(void)
+ {
+ #if (POOL_WAIT == STD_ON)
+     static TPool_handle wait_pool;
+     pthread_t thread;
+     uint64 start;
+     uint32 i;
+     
+     pool_init(&wait_pool);
+     TEST_ASSERT(pool_alloc_wait(NULL_PTR, 0U) == NULL_PTR);
+     
+     /* Free blocks are returned without waiting */
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         wait_block = pool_alloc_wait(&wait_pool, POOL_WAIT_FOREVER);
+     }
+     TEST_ASSERT((wait_block != NULL_PTR) && (pool_get_free_count(&wait_pool) == 0U));
+     
+     /* Exhausted: a zero timeout tries once, a short one expires */
+     TEST_ASSERT(pool_alloc_wait(&wait_pool, 0U) == NULL_PTR);
+     start = pool_os_now_ns();
+     TEST_ASSERT(pool_alloc_wait(&wait_pool, 2000000ULL) == NULL_PTR);
+     TEST_ASSERT((pool_os_now_ns() - start) >= 2000000ULL);
+     TEST_ASSERT((wait_pool.wait.waiters == 0U) && (wait_pool.wait.lock == 0U));
+     
+     /* Frees without waiters leave the futex word alone */
+     pool_free(&wait_pool, wait_block);
+     TEST_ASSERT(wait_pool.wait.seq == 0U);
+     wait_block = pool_alloc(&wait_pool);
+     
+     /* A free from another thread wakes the sleeper and hands it the block */
+     TEST_ASSERT(pthread_create(&thread, NULL_PTR, wait_free_later, &wait_pool) == 0);
+     TEST_ASSERT(pool_alloc_wait(&wait_pool, POOL_WAIT_FOREVER) == wait_block);
+     (void)pthread_join(thread, NULL_PTR);
+     TEST_ASSERT((wait_pool.wait.seq == 1U) && (wait_pool.wait.waiters == 0U));
+ #endif
+ }
+
+ #if (POOL_WATERMARKS == STD_ON) && defined(__linux__)
+ #include <unistd.h>
+ #include <sys/eventfd.h>
+ 
+ /**
+  * @brief Read and reset the counter of a non-blocking eventfd
+  */
+ static uint64 take_events(int fd)
+ {
+     uint64 count = 0U;
+     
+     return (read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) ? count : 0U;
+ }
+ #endif
+ 
+ /**
+  * @brief Test eventfd signals on watermark crossings
+  */
+ static void test_watermarks(void)
+ {
+ #if (POOL_WATERMARKS == STD_ON) && defined(__linux__)
+     static TPool_handle wm_pool;
+     void* blocks[POOL_NUM_BLOCKS];
+     const TPool_index low = (TPool_index)(POOL_NUM_BLOCKS / 2U);
+     const TPool_index high = (TPool_index)POOL_NUM_BLOCKS;
+     int fd = eventfd(0U, EFD_NONBLOCK);
+     boolean quiet = TRUE;
+     uint32 i;
+     
+     pool_init(&wm_pool);
+     TEST_ASSERT(fd >= 0);
+     TEST_ASSERT(pool_set_watermarks(NULL_PTR, low, high, fd) == STD_NOT_OK);
+     TEST_ASSERT(pool_set_watermarks(&wm_pool, high, high, fd) == STD_NOT_OK);
+     TEST_ASSERT(pool_set_watermarks(&wm_pool, low, (TPool_index)(POOL_NUM_BLOCKS + 1U), fd) == STD_NOT_OK);
+     TEST_ASSERT(pool_set_watermarks(&wm_pool, low, high, fd) == STD_OK);
+     
+     /* The climb is signalled once, by the allocation reaching high */
+     for (i = 0U; i < (POOL_NUM_BLOCKS - 1U); i++) {
+         blocks[i] = (i % 2U) ? pool_alloc(&wm_pool) : pool_alloc_fast(&wm_pool);
+         quiet = (boolean)(quiet && (take_events(fd) == 0U));
+     }
+     TEST_ASSERT(quiet && (FALSE == pool_watermark_is_high(&wm_pool)));
+     blocks[POOL_NUM_BLOCKS - 1U] = pool_alloc(&wm_pool);
+     TEST_ASSERT((take_events(fd) == 1U) && (TRUE == pool_watermark_is_high(&wm_pool)));
+     
+     /* The fall is signalled once, by the free reaching low */
+     for (i = POOL_NUM_BLOCKS - 1U; i > low; i--) {
+         pool_free(&wm_pool, blocks[i]);
+         pool_free(&wm_pool, blocks[i]);  /* Rejected double free changes nothing */
+         quiet = (boolean)(quiet && (take_events(fd) == 0U));
+     }
+     TEST_ASSERT(quiet && (TRUE == pool_watermark_is_high(&wm_pool)));
+     pool_free_fast(&wm_pool, blocks[low]);
+     TEST_ASSERT((take_events(fd) == 1U) && (FALSE == pool_watermark_is_high(&wm_pool)));
+     
+     /* Hysteresis: dropping and climbing between the watermarks is quiet */
+     blocks[low] = pool_alloc(&wm_pool);
+     pool_free(&wm_pool, blocks[low]);
+     TEST_ASSERT(take_events(fd) == 0U);
+     
+     /* A reset of a full pool signals the fall */
+     for (i = low; i < POOL_NUM_BLOCKS; i++) {
+         blocks[i] = pool_alloc(&wm_pool);
+     }
+     TEST_ASSERT(take_events(fd) == 1U);
+     pool_init_ex(&wm_pool, POOL_INIT_METADATA);
+     TEST_ASSERT((take_events(fd) == 1U) && (FALSE == pool_watermark_is_high(&wm_pool)));
+     
+     /* Disabled watermarks stay quiet */
+     TEST_ASSERT(pool_set_watermarks(&wm_pool, 0U, 0U, -1) == STD_OK);
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         (void)pool_alloc(&wm_pool);
+     }
+     TEST_ASSERT(take_events(fd) == 0U);
+     (void)close(fd);
+ #endif
+ }
+
+ #if (POOL_RECLAIM == STD_ON)
+ /**
+  * @brief State of a reclaim hook of the reclaim test
+  */
+ typedef struct {
+     uint32 calls;       /* Number of runs of the hook */
+     void* spare;        /* Block given back on the next run, NULL for none */
+     boolean nested;     /* Allocate from the pool inside the hook */
+     void* nested_block; /* Result of that allocation */
+ } TReclaim_probe;
+ 
+ static TPool_index reclaim_probe(TPool_handle* p_handle, TPool_index max_blocks, void* p_arg)
+ {
+     TReclaim_probe* probe = (TReclaim_probe*)p_arg;
+     TPool_index released = 0U;
+     
+     probe->calls++;
+     if (probe->nested) {
+         probe->nested_block = pool_alloc(p_handle);
+     }
+     if ((NULL_PTR != probe->spare) && (max_blocks > 0U)) {
+         pool_free(p_handle, probe->spare);
+         probe->spare = NULL_PTR;
+         released = 1U;
+     }
+     return released;
+ }
+ #endif
+ 
+ /**
+  * @brief Test reclaim hooks run on exhaustion
+  */
+ static void test_reclaim(void)
+ {
+ #if (POOL_RECLAIM == STD_ON)
+     static TPool_handle reclaim_pool;
+     TCache_counters counters = { 0U, 0U, FALSE };
+     TReclaim_probe first = { 0U, NULL_PTR, FALSE, NULL_PTR };
+     TReclaim_probe second = { 0U, NULL_PTR, FALSE, NULL_PTR };
+     void* objects[POOL_NUM_BLOCKS];
+     TPool_stats stats;
+     TPool_cache cache;
+     void* block;
+     uint32 i;
+     
+     pool_init(&reclaim_pool);
+     TEST_ASSERT(pool_reclaim_register(NULL_PTR, reclaim_probe, &first) == STD_NOT_OK);
+     TEST_ASSERT(pool_reclaim_register(&reclaim_pool, NULL_PTR, &first) == STD_NOT_OK);
+     
+     /* Without hooks exhaustion still counts a run but rescues nothing */
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         objects[i] = pool_alloc(&reclaim_pool);
+     }
+     TEST_ASSERT(pool_alloc(&reclaim_pool) == NULL_PTR);
+     (void)pool_get_stats(&reclaim_pool, &stats);
+     TEST_ASSERT((stats.reclaim_runs == 1U) && (stats.reclaim_rescues == 0U));
+     
+     /* Hooks run in order and the chain stops at the first one that frees */
+     TEST_ASSERT(pool_reclaim_register(&reclaim_pool, reclaim_probe, &first) == STD_OK);
+     TEST_ASSERT(pool_reclaim_register(&reclaim_pool, reclaim_probe, &first) == STD_NOT_OK);
+     TEST_ASSERT(pool_reclaim_register(&reclaim_pool, reclaim_probe, &second) == STD_OK);
+     first.spare = objects[1];
+     TEST_ASSERT(pool_alloc(&reclaim_pool) == objects[1]);
+     TEST_ASSERT((first.calls == 1U) && (second.calls == 0U));
+     second.spare = objects[2];
+     TEST_ASSERT(pool_alloc_fast(&reclaim_pool) == objects[2]);
+     TEST_ASSERT((first.calls == 2U) && (second.calls == 1U));
+     (void)pool_get_stats(&reclaim_pool, &stats);
+     TEST_ASSERT((stats.reclaim_runs == 3U) && (stats.reclaim_rescues == 2U));
+     
+     /* A hook allocating from the same pool gets NULL instead of recursing */
+     first.nested = TRUE;
+     TEST_ASSERT(pool_alloc(&reclaim_pool) == NULL_PTR);
+     TEST_ASSERT((first.nested_block == NULL_PTR) && (first.calls == 3U));
+     (void)pool_get_stats(&reclaim_pool, &stats);
+     TEST_ASSERT((stats.reclaim_runs == 4U) && (stats.reclaim_rescues == 2U));
+     first.nested = FALSE;
+     
+     pool_reclaim_unregister(&reclaim_pool, reclaim_probe, &first);
+     pool_reclaim_unregister(&reclaim_pool, reclaim_probe, &first);
+     TEST_ASSERT(pool_alloc(&reclaim_pool) == NULL_PTR);
+     TEST_ASSERT((first.calls == 3U) && (second.calls == 3U));
+     pool_reclaim_unregister(&reclaim_pool, reclaim_probe, &second);
+     
+     /* An object cache sheds cached objects for an unrelated allocation */
+     pool_init(&reclaim_pool);
+     (void)pool_cache_init(&cache, &reclaim_pool, cache_ctor, cache_dtor, &counters);
+     TEST_ASSERT(pool_reclaim_register(&reclaim_pool, pool_cache_reclaim, &cache) == STD_OK);
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         objects[i] = pool_cache_alloc(&cache);
+     }
+     for (i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         pool_cache_free(&cache, objects[i]);
+     }
+     block = pool_alloc(&reclaim_pool);
+     TEST_ASSERT(block != NULL_PTR);
+     TEST_ASSERT(counters.dtor_calls == ((POOL_NUM_BLOCKS < POOL_RECLAIM_BATCH) ? POOL_NUM_BLOCKS : POOL_RECLAIM_BATCH));
+     TEST_ASSERT(pool_cache_get_cached_count(&cache) == (POOL_NUM_BLOCKS - counters.dtor_calls));
+     TEST_ASSERT(pool_cache_alloc(&cache) != block);
+     pool_reclaim_unregister(&reclaim_pool, pool_cache_reclaim, &cache);
+ #endif
+ }
+ 
+ /**
+  * @brief Test allocation classes with quotas and the priority reserve
+  */
+ static void test_quota(void)
+ {
+ #if (POOL_QUOTA == STD_ON)
+     static TPool_handle quota_pool;
+     void* blocks[POOL_NUM_BLOCKS];
+     void* plain;
+     void* block;
+     uint32 count = 0U;
+     uint32 i;
+     
+     pool_init(&quota_pool);
+     TEST_ASSERT(pool_quota_set_class(NULL_PTR, 0U, 2U, POOL_PRIORITY_NORMAL) == STD_NOT_OK);
+     TEST_ASSERT(pool_quota_set_class(&quota_pool, POOL_QUOTA_MAX_CLASSES, 2U, POOL_PRIORITY_NORMAL) == STD_NOT_OK);
+     TEST_ASSERT(pool_quota_set_reserve(&quota_pool, (TPool_index)(POOL_NUM_BLOCKS + 1U)) == STD_NOT_OK);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, POOL_QUOTA_MAX_CLASSES) == NULL_PTR);
+     
+     /* Class 0 is capped at 2 blocks, class 1 only by the reserve, class 2 may use it */
+     TEST_ASSERT(pool_quota_set_class(&quota_pool, 0U, 2U, POOL_PRIORITY_NORMAL) == STD_OK);
+     TEST_ASSERT(pool_quota_set_class(&quota_pool, 2U, 0U, POOL_PRIORITY_HIGH) == STD_OK);
+     TEST_ASSERT(pool_quota_set_reserve(&quota_pool, 1U) == STD_OK);
+     
+     blocks[count++] = pool_quota_alloc(&quota_pool, 0U);
+     blocks[count++] = pool_quota_alloc(&quota_pool, 0U);
+     TEST_ASSERT((blocks[0] != NULL_PTR) && (blocks[1] != NULL_PTR));
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) == NULL_PTR);
+     TEST_ASSERT(pool_quota_get_used(&quota_pool, 0U) == 2U);
+     
+     /* A runaway class stops at the reserve, the high-priority class still gets it */
+     while (NULL_PTR != (block = pool_quota_alloc(&quota_pool, 1U))) {
+         blocks[count++] = block;
+     }
+     TEST_ASSERT(count == (POOL_NUM_BLOCKS - 1U));
+     TEST_ASSERT(pool_get_free_count(&quota_pool) == 1U);
+     TEST_ASSERT(pool_quota_get_used(&quota_pool, 1U) == (POOL_NUM_BLOCKS - 3U));
+     blocks[count] = pool_quota_alloc(&quota_pool, 2U);
+     TEST_ASSERT(blocks[count] != NULL_PTR);
+     count++;
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 2U) == NULL_PTR);
+     TEST_ASSERT(pool_quota_get_used(&quota_pool, 2U) == 1U);
+     
+     /* Freeing releases the charge of the owner class; bad frees change nothing */
+     pool_quota_free(&quota_pool, blocks[0]);
+     TEST_ASSERT(pool_quota_get_used(&quota_pool, 0U) == 1U);
+     pool_quota_free(&quota_pool, blocks[0]);
+     pool_quota_free(&quota_pool, (uint8*)blocks[1] + 1);
+     pool_quota_free(&quota_pool, NULL_PTR);
+     TEST_ASSERT(pool_quota_get_used(&quota_pool, 0U) == 1U);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 1U) == NULL_PTR);
+     plain = pool_alloc(&quota_pool);
+     TEST_ASSERT(plain == blocks[0]);
+     pool_quota_free(&quota_pool, plain);
+     TEST_ASSERT(pool_get_free_count(&quota_pool) == 0U);
+     pool_free(&quota_pool, plain);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) == NULL_PTR);
+     blocks[0] = pool_quota_alloc(&quota_pool, 2U);
+     TEST_ASSERT(blocks[0] != NULL_PTR);
+     
+     for (i = 0U; i < count; i++) {
+         pool_quota_free(&quota_pool, blocks[i]);
+     }
+     TEST_ASSERT(pool_get_free_count(&quota_pool) == POOL_NUM_BLOCKS);
+     TEST_ASSERT((pool_quota_get_used(&quota_pool, 0U) == 0U) && (pool_quota_get_used(&quota_pool, 1U) == 0U) &&
+                 (pool_quota_get_used(&quota_pool, 2U) == 0U));
+     
+     /* Re-initialization drops the charges and keeps the classes */
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) != NULL_PTR);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) != NULL_PTR);
+     pool_init_ex(&quota_pool, POOL_INIT_METADATA);
+     TEST_ASSERT(pool_quota_get_used(&quota_pool, 0U) == 0U);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) != NULL_PTR);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) != NULL_PTR);
+     TEST_ASSERT(pool_quota_alloc(&quota_pool, 0U) == NULL_PTR);
+ #endif
+ }
@@ -6,9 +6,30 @@
  #ifndef TEST_POOL_H
  #define TEST_POOL_H
  
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+ 
  /**
   * @brief Run all memory pool tests
   */
  void run_all_tests(void);
  
- #endif /* TEST_POOL_H */
\ No newline at end of file
+ /**
+  * @brief Count and print the result of an assertion made in another test file
+  * @param passed Non-zero if the assertion held
+  * @param file   Source file of the assertion
+  * @param line   Source line of the assertion
+  */
+ void test_record(int passed, const char* file, int line);
+ 
+ /**
+  * @brief Run the tests of the C++ interface (test_pool_cpp.cpp)
+  */
+ void run_cpp_tests(void);
+ 
+ #ifdef __cplusplus
+ }
+ #endif
+ 
+ #endif /* TEST_POOL_H */
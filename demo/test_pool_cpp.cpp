@@ -0,0 +1,642 @@
+/**
+ * @file        test_pool_cpp.cpp
+ * @brief       Test suite for the C++ interface of the memory pool
+ * @details     Results are counted together with the C tests through test_record().
+ */
+
+ #include <coroutine>
+ #include <deque>
+ #include <exception>
+ #include <list>
+ #include <map>
+ #include <memory_resource>
+ #include <type_traits>
+ #include <utility>
+ #include <vector>
+ #include "test_pool.h"
+ #include "static_pool.hpp"
+ #include "pool_allocator.hpp"
+ #include "object_pool.hpp"
+ #include "pool_ptr.hpp"
+ #include "pool_coro.hpp"
+ #include "pool_await.hpp"
+ 
+ /**
+  * @brief Helper macro for test assertions
+  */
+ #define TEST_ASSERT(condition) test_record((condition) ? 1 : 0, __FILE__, __LINE__)
+ 
+ /* Single-word pool, usable without any start-up code */
+ constinit static StaticPool<32U, 4U> small_pool;
+ 
+ /* Multi-word pool with padding bits in the last word */
+ constinit static StaticPool<16U, 130U> wide_pool;
+ 
+ /* Compile-time selection of the bitmap word and the counters */
+ static_assert(std::is_same_v<StaticPool<32U, 4U>::word_type, uint8>);
+ static_assert(std::is_same_v<StaticPool<32U, 4U>::index_type, uint8>);
+ static_assert(std::is_same_v<StaticPool<8U, 16U>::word_type, uint16>);
+ static_assert(std::is_same_v<StaticPool<8U, 64U>::word_type, uint64>);
+ static_assert(std::is_same_v<StaticPool<16U, 130U>::index_type, uint8>);
+ static_assert(std::is_same_v<StaticPool<8U, 300U>::index_type, uint16>);
+ static_assert(StaticPool<8U, 4U>::alignment == 8U);
+ static_assert(StaticPool<48U, 4U>::alignment == 16U);
+ 
+ /**
+  * @brief Test the single-word StaticPool
+  */
+ static void test_static_pool_small(void)
+ {
+     void* blocks[4];
+     
+     TEST_ASSERT(small_pool.free_count() == 4U);
+     for (uint32 i = 0U; i < 4U; i++) {
+         blocks[i] = small_pool.allocate();
+     }
+     TEST_ASSERT(blocks[0] != nullptr);
+     TEST_ASSERT(static_cast<uint8*>(blocks[3]) == static_cast<uint8*>(blocks[0]) + (3U * 32U));
+     TEST_ASSERT(small_pool.allocate() == nullptr);
+     TEST_ASSERT(small_pool.free_count() == 0U);
+     
+     /* Invalid frees are ignored */
+     small_pool.deallocate(nullptr);
+     small_pool.deallocate(static_cast<uint8*>(blocks[1]) + 1);
+     small_pool.deallocate(&wide_pool);
+     TEST_ASSERT(small_pool.free_count() == 0U);
+     TEST_ASSERT(small_pool.owns(blocks[2]));
+     TEST_ASSERT(!small_pool.owns(static_cast<uint8*>(blocks[2]) + 4));
+     TEST_ASSERT(!small_pool.owns(&wide_pool));
+     
+     /* The lowest free block is reused first */
+     small_pool.deallocate(blocks[2]);
+     small_pool.deallocate(blocks[1]);
+     small_pool.deallocate(blocks[1]);  /* Double free is ignored */
+     TEST_ASSERT(small_pool.free_count() == 2U);
+     TEST_ASSERT(small_pool.allocate() == blocks[1]);
+     small_pool.deallocate_unchecked(blocks[0]);
+     TEST_ASSERT(small_pool.allocate() == blocks[0]);
+     
+     small_pool.reset();
+     TEST_ASSERT(small_pool.free_count() == 4U);
+     TEST_ASSERT(small_pool.allocate() == blocks[0]);
+ }
+ 
+ /**
+  * @brief Test the multi-word StaticPool and block alignment
+  */
+ static void test_static_pool_wide(void)
+ {
+     static StaticPool<64U, 3U, 64U> aligned_pool;
+     uint8* blocks[130];
+     bool all_ok = true;
+     
+     for (uint32 i = 0U; i < 130U; i++) {
+         blocks[i] = static_cast<uint8*>(wide_pool.allocate());
+         all_ok = all_ok && (blocks[i] == blocks[0] + (i * 16U));
+     }
+     TEST_ASSERT(all_ok);
+     TEST_ASSERT(wide_pool.allocate() == nullptr);
+     
+     wide_pool.deallocate(blocks[129]);
+     wide_pool.deallocate(blocks[70]);
+     TEST_ASSERT(wide_pool.free_count() == 2U);
+     TEST_ASSERT(wide_pool.allocate() == blocks[70]);
+     TEST_ASSERT(wide_pool.allocate() == blocks[129]);
+     TEST_ASSERT(wide_pool.allocate() == nullptr);
+     
+     all_ok = true;
+     for (uint32 i = 0U; i < 3U; i++) {
+         all_ok = all_ok && ((reinterpret_cast<uintptr>(aligned_pool.allocate()) % 64U) == 0U);
+     }
+     TEST_ASSERT(all_ok);
+ }
+ 
+ /**
+  * @brief Test PoolAllocator with std containers over the C pool
+  */
+ static void test_pool_allocator(void)
+ {
+     static TPool_handle pool;
+     pool_init(&pool);
+     
+     {
+         PoolAllocator<int> alloc(pool);
+         std::list<int, PoolAllocator<int>> list(alloc);
+         
+         /* Nodes come from the pool until it is exhausted, then from the heap */
+         for (int i = 0; i < (int)(POOL_NUM_BLOCKS + 2U); i++) {
+             list.push_back(i);
+         }
+         TEST_ASSERT(pool_get_free_count(&pool) == 0U);
+         TEST_ASSERT(list.size() == POOL_NUM_BLOCKS + 2U);
+         TEST_ASSERT(list.back() == (int)(POOL_NUM_BLOCKS + 1U));
+         
+         list.pop_front();
+         TEST_ASSERT(pool_get_free_count(&pool) == 1U);
+         list.pop_back();  /* Heap node goes back to the heap */
+         TEST_ASSERT(pool_get_free_count(&pool) == 1U);
+         
+         /* Rebound copies share the pool */
+         PoolAllocator<double> rebound(alloc);
+         TEST_ASSERT(rebound == alloc);
+         TEST_ASSERT(rebound.pool() == &pool);
+         
+         /* Multi-object requests bypass the pool, even when they would fit a block */
+         std::vector<int, PoolAllocator<int>> vec(2U, 7, alloc);
+         TEST_ASSERT(pool_get_free_count(&pool) == 1U);
+         TEST_ASSERT(vec[1] == 7);
+     }
+     TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS);
+ }
+ 
+ /**
+  * @brief Test pool_memory_resource with pmr containers
+  */
+ static void test_pool_memory_resource(void)
+ {
+     static TPool_handle pool;
+     static StaticPool<64U, 16U> nodes;
+     pool_init(&pool);
+     
+     {
+         pool_memory_resource resource(pool);
+         std::pmr::list<int> list(&resource);
+         
+         TEST_ASSERT(resource.pool() == &pool);
+         TEST_ASSERT(resource.upstream_resource() == std::pmr::get_default_resource());
+         TEST_ASSERT(resource.is_equal(resource));
+         
+         for (int i = 0; i < (int)(POOL_NUM_BLOCKS + 2U); i++) {
+             list.push_back(i);
+         }
+         TEST_ASSERT(pool_get_free_count(&pool) == 0U);
+         
+         /* Oversize requests go upstream */
+         void* big = resource.allocate(POOL_BLOCK_SIZE + 1U);
+         TEST_ASSERT(!pool_traits<TPool_handle>::owns(pool, big));
+         resource.deallocate(big, POOL_BLOCK_SIZE + 1U);
+         
+         list.clear();
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS);
+     }
+     
+     /* Map nodes from a StaticPool */
+     {
+         basic_pool_memory_resource<StaticPool<64U, 16U>> resource(nodes);
+         std::pmr::map<int, int> map(&resource);
+         pool_memory_resource other(pool);
+         
+         for (int i = 0; i < 10; i++) {
+             map[i] = i * i;
+         }
+         TEST_ASSERT(nodes.free_count() == 6U);
+         TEST_ASSERT(map[9] == 81);
+         TEST_ASSERT(!resource.is_equal(other));
+         map.erase(3);
+         TEST_ASSERT(nodes.free_count() == 7U);
+     }
+     TEST_ASSERT(nodes.free_count() == 16U);
+ }
+ 
+ /* Object counting constructions and destructions */
+ struct Tracked
+ {
+     static inline int alive = 0;
+     int value;
+     
+     explicit Tracked(int v) : value(v)
+     {
+         if (v < 0) {
+             throw v;
+         }
+         alive++;
+     }
+     ~Tracked() { alive--; }
+ };
+ 
+ /* Over-aligned trivially destructible object */
+ struct alignas(64) Line
+ {
+     uint8 bytes[64];
+ };
+ 
+ static_assert(ObjectPool<Tracked, 4U>::tracks_live);
+ static_assert(!ObjectPool<Line, 4U>::tracks_live);
+ static_assert(sizeof(ObjectPool<Line, 4U>) == sizeof(StaticPool<64U, 4U, 64U>));
+ 
+ /**
+  * @brief Test ObjectPool construction, destruction and live tracking
+  */
+ static void test_object_pool(void)
+ {
+     static Tracked outside(1);
+     
+     {
+         ObjectPool<Tracked, 3U> pool;
+         Tracked* a = pool.create(10);
+         Tracked* b = pool.create(20);
+         
+         TEST_ASSERT((a != nullptr) && (a->value == 10) && (b->value == 20));
+         TEST_ASSERT(Tracked::alive == 3);
+         TEST_ASSERT(pool.owns(a) && !pool.owns(&outside));
+         
+         /* A throwing constructor gives the block back */
+         bool thrown = false;
+         try {
+             (void)pool.create(-1);
+         } catch (int) {
+             thrown = true;
+         }
+         TEST_ASSERT(thrown && (pool.free_count() == 1U));
+         
+         TEST_ASSERT(pool.create(30) != nullptr);
+         TEST_ASSERT(pool.create(40) == nullptr);  /* Exhausted */
+         
+         /* Invalid destroys are ignored with live tracking */
+         pool.destroy(a);
+         pool.destroy(a);
+         pool.destroy(&outside);
+         pool.destroy(nullptr);
+         TEST_ASSERT(Tracked::alive == 3);
+         TEST_ASSERT(pool.create(50) == a);
+     }
+     /* Objects still alive are destroyed with the pool */
+     TEST_ASSERT(Tracked::alive == 1);
+     
+     {
+         static ObjectPool<Line, 2U> lines;
+         Line* l = lines.create();
+         TEST_ASSERT((reinterpret_cast<uintptr>(l) % 64U) == 0U);
+         lines.destroy(l);
+         TEST_ASSERT(lines.free_count() == 2U);
+     }
+ }
+ 
+ /* Object larger than a block of the C pool */
+ struct Big
+ {
+     uint8 bytes[POOL_BLOCK_SIZE * 2U];
+ };
+ 
+ /* Derived whose second base does not start at the object */
+ struct PtrBaseA
+ {
+     virtual ~PtrBaseA() = default;
+     uint32 a = 1U;
+ };
+ 
+ struct PtrBaseB
+ {
+     virtual ~PtrBaseB() = default;
+     uint32 b = 2U;
+ };
+ 
+ struct PtrDerived : PtrBaseA, PtrBaseB
+ {
+     static int destroyed;
+     ~PtrDerived() override { destroyed++; }
+ };
+ 
+ int PtrDerived::destroyed = 0;
+ 
+ struct PtrPlain
+ {
+     uint32 value = 0U;
+ };
+ 
+ struct PtrPlainDerived : PtrPlain
+ {
+ };
+ 
+ /* Over-aligned derived: its heap fallback cannot be freed through the base */
+ struct alignas(64) PtrWideDerived : PtrBaseA
+ {
+ };
+ 
+ /* Records the size of the one allocation std::allocate_shared makes; as large as a PoolAllocator */
+ static std::size_t probed_bytes = 0U;
+ 
+ template <typename T>
+ struct SharedProbe
+ {
+     using value_type = T;
+     
+     void* pool = nullptr;
+     
+     SharedProbe() noexcept = default;
+     
+     template <typename U>
+     SharedProbe(const SharedProbe<U>&) noexcept {}
+     
+     T* allocate(std::size_t n)
+     {
+         probed_bytes = sizeof(T) * n;
+         return std::allocator<T>{}.allocate(n);
+     }
+     
+     void deallocate(T* p, std::size_t n) noexcept
+     {
+         std::allocator<T>{}.deallocate(p, n);
+     }
+     
+     template <typename U>
+     bool operator==(const SharedProbe<U>&) const noexcept
+     {
+         return true;
+     }
+ };
+ 
+ static_assert(sizeof(SharedProbe<int>) == sizeof(PoolAllocator<int>));
+ 
+ static_assert(sizeof(pool_unique_ptr<int>) == sizeof(int*));
+ static_assert(std::is_convertible_v<pool_unique_ptr<PtrDerived>, pool_unique_ptr<PtrBaseB>>);
+ static_assert(!std::is_convertible_v<pool_unique_ptr<PtrPlainDerived>, pool_unique_ptr<PtrPlain>>);
+ static_assert(!std::is_convertible_v<pool_unique_ptr<PtrWideDerived>, pool_unique_ptr<PtrBaseA>>);
+ 
+ /**
+  * @brief Test pool_unique_ptr and pool_allocate_shared
+  */
+ static void test_pool_ptr(void)
+ {
+     static TPool_handle pool;
+     static TPool_handle unregistered;
+     pool_init(&pool);
+     pool_init(&unregistered);
+     TEST_ASSERT(pool_register(&pool) == STD_OK);
+     
+     {
+         pool_unique_ptr<int> a = pool_make_unique<int>(pool, 42);
+         TEST_ASSERT((*a == 42) && (pool_owns(a.get()) == &pool));
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS - 1U);
+         a.reset();
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS);
+         
+         /* Heap fallback for oversize objects and unregistered pools */
+         pool_unique_ptr<Big> big = pool_make_unique<Big>(pool);
+         pool_unique_ptr<int> loose = pool_make_unique<int>(unregistered, 1);
+         TEST_ASSERT((pool_owns(big.get()) == nullptr) && (pool_owns(loose.get()) == nullptr));
+         TEST_ASSERT(pool_get_free_count(&unregistered) == POOL_NUM_BLOCKS);
+         
+         /* A throwing constructor releases the block */
+         bool thrown = false;
+         try {
+             (void)pool_make_unique<Tracked>(pool, -1);
+         } catch (int) {
+             thrown = true;
+         }
+         TEST_ASSERT(thrown && (pool_get_free_count(&pool) == POOL_NUM_BLOCKS));
+     }
+     
+     {
+         /* Converted to a base that is not the first one, freed from the block start */
+         pool_unique_ptr<PtrDerived> d = pool_make_unique<PtrDerived>(pool);
+         void* p_start = d.get();
+         pool_unique_ptr<PtrBaseB> b = std::move(d);
+         TEST_ASSERT(static_cast<void*>(b.get()) != p_start);
+         if constexpr (sizeof(PtrDerived) <= POOL_BLOCK_SIZE)
+         {
+             TEST_ASSERT(pool_owns(p_start) == &pool);
+             TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS - 1U);
+         }
+         b.reset();
+         TEST_ASSERT((PtrDerived::destroyed == 1) && (pool_get_free_count(&pool) == POOL_NUM_BLOCKS));
+         
+         /* Same from the heap */
+         pool_unique_ptr<PtrBaseB> loose = pool_make_unique<PtrDerived>(unregistered);
+         TEST_ASSERT(pool_owns(loose.get()) == nullptr);
+         loose.reset();
+         TEST_ASSERT(PtrDerived::destroyed == 2);
+     }
+     
+     {
+         /* Control block and object share one block, if the library's layout fits it */
+         (void)std::allocate_shared<int>(SharedProbe<int>{}, 0);
+         const uintptr held = (probed_bytes <= POOL_BLOCK_SIZE) ? 1U : 0U;
+         
+         std::shared_ptr<int> s = pool_allocate_shared<int>(pool, 7);
+         TEST_ASSERT((*s == 7) && (pool_get_free_count(&pool) == POOL_NUM_BLOCKS - held));
+         std::shared_ptr<int> copy = s;
+         std::weak_ptr<int> weak = s;
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS - held);
+         s.reset();
+         copy.reset();
+         TEST_ASSERT(weak.expired());
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS - held);  /* Held by the weak count */
+         weak.reset();
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS);
+         
+         std::shared_ptr<Big> big = pool_allocate_shared<Big>(pool);
+         TEST_ASSERT(pool_get_free_count(&pool) == POOL_NUM_BLOCKS);
+     }
+     
+     pool_unregister(&pool);
+ }
+ 
+ /* Coroutine frames: blocks of the C pool, then four times larger blocks */
+ using FrameMediumPool = StaticPool<POOL_BLOCK_SIZE * 4U, 2U>;
+ static TPool_handle frame_small_pool;
+ constinit static FrameMediumPool frame_medium_pool;
+ constinit static FramePools<TPool_handle, FrameMediumPool> test_frames{frame_small_pool, frame_medium_pool};
+ 
+ static_assert(decltype(test_frames)::max_frame_size == POOL_BLOCK_SIZE * 4U);
+ 
+ /**
+  * @brief Minimal lazily started coroutine with a pooled frame
+  */
+ struct FrameTask
+ {
+     struct promise_type : pool_frame_promise<test_frames>
+     {
+         FrameTask get_return_object() noexcept
+         {
+             return FrameTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+         }
+         std::suspend_always initial_suspend() noexcept { return {}; }
+         std::suspend_always final_suspend() noexcept { return {}; }
+         void return_void() noexcept {}
+         void unhandled_exception() noexcept { std::terminate(); }
+     };
+     
+     explicit FrameTask(std::coroutine_handle<promise_type> h) noexcept : handle(h) {}
+     FrameTask(FrameTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+     ~FrameTask()
+     {
+         if (handle) {
+             handle.destroy();
+         }
+     }
+     
+     std::coroutine_handle<promise_type> handle;
+ };
+ 
+ static FrameTask add_twice(uint32& total, uint32 step)
+ {
+     total += step;
+     co_await std::suspend_always{};
+     total += step;
+ }
+ 
+ static FrameTask add_large(uint32& total)
+ {
+     volatile uint8 scratch[FrameMediumPool::block_size * 2U];  /* Lives across the suspension */
+     scratch[0] = 1U;
+     co_await std::suspend_always{};
+     total += scratch[0];
+ }
+ 
+ /**
+  * @brief Test coroutine frames served by FramePools
+  */
+ static void test_pool_coro(void)
+ {
+     uint32 total = 0U;
+     
+     pool_init(&frame_small_pool);
+     const uintptr capacity = pool_get_free_count(&frame_small_pool) + frame_medium_pool.free_count();
+     
+     {
+         FrameTask task = add_twice(total, 1U);
+         TEST_ASSERT(test_frames.owns(task.handle.address()));
+         TEST_ASSERT((pool_get_free_count(&frame_small_pool) + frame_medium_pool.free_count()) == capacity - 1U);
+         TEST_ASSERT(total == 0U);  /* Lazily started */
+         task.handle.resume();
+         task.handle.resume();
+         TEST_ASSERT(task.handle.done() && (total == 2U));
+     }
+     TEST_ASSERT((pool_get_free_count(&frame_small_pool) + frame_medium_pool.free_count()) == capacity);
+     
+     /* Oversize frames come from the heap */
+     {
+         FrameTask task = add_large(total);
+         TEST_ASSERT(!test_frames.owns(task.handle.address()));
+         task.handle.resume();
+         task.handle.resume();
+         TEST_ASSERT(total == 3U);
+     }
+     TEST_ASSERT((pool_get_free_count(&frame_small_pool) + frame_medium_pool.free_count()) == capacity);
+     
+     /* Exhausted classes spill into larger ones, then to the heap */
+     {
+         std::vector<FrameTask> tasks;
+         uintptr pooled = 0U;
+         tasks.reserve(capacity + 1U);
+         for (uintptr i = 0U; i <= capacity; i++) {
+             tasks.push_back(add_twice(total, 1U));
+             pooled += test_frames.owns(tasks.back().handle.address()) ? 1U : 0U;
+         }
+         TEST_ASSERT(frame_medium_pool.free_count() == 0U);
+         TEST_ASSERT(!test_frames.owns(tasks.back().handle.address()));
+         TEST_ASSERT((pool_get_free_count(&frame_small_pool) + frame_medium_pool.free_count()) == capacity - pooled);
+         for (FrameTask& task : tasks) {
+             task.handle.resume();
+             task.handle.resume();
+         }
+         TEST_ASSERT(total == 3U + (2U * (capacity + 1U)));
+     }
+     TEST_ASSERT((pool_get_free_count(&frame_small_pool) + frame_medium_pool.free_count()) == capacity);
+ }
+ 
+ /**
+  * @brief Executor resuming posted coroutines only when its loop runs
+  */
+ struct QueueExecutor
+ {
+     void post(std::coroutine_handle<> handle)
+     {
+         ready.push_back(handle);
+     }
+     
+     void run()
+     {
+         while (!ready.empty()) {
+             std::coroutine_handle<> handle = ready.front();
+             ready.pop_front();
+             handle.resume();
+         }
+     }
+     
+     std::deque<std::coroutine_handle<>> ready;
+ };
+ 
+ static FrameTask acquire_queued(AwaitablePool<>& pool, QueueExecutor& executor, void*& slot)
+ {
+     slot = co_await pool.acquire(executor);
+ }
+ 
+ static FrameTask acquire_inline(AwaitablePool<>& pool, void*& slot)
+ {
+     slot = co_await pool.acquire();
+ }
+ 
+ /**
+  * @brief Test awaitable acquisition and direct hand-over to waiters
+  */
+ static void test_pool_await(void)
+ {
+     static TPool_handle pool;
+     AwaitablePool<> waitable(pool);
+     QueueExecutor executor;
+     std::vector<void*> blocks;
+     void* slots[4] = { nullptr, nullptr, nullptr, nullptr };
+     
+     pool_init(&pool);
+     
+     /* Completes without suspending while blocks are free */
+     for (uintptr i = 0U; i < POOL_NUM_BLOCKS; i++) {
+         void* block = nullptr;
+         FrameTask task = acquire_inline(waitable, block);
+         task.handle.resume();
+         blocks.push_back(block);
+         if (!task.handle.done() || (block == nullptr)) {
+             break;
+         }
+     }
+     TEST_ASSERT((blocks.size() == POOL_NUM_BLOCKS) && (pool_get_free_count(&pool) == 0U));
+     
+     /* Waiters queue up in arrival order */
+     FrameTask first = acquire_queued(waitable, executor, slots[0]);
+     FrameTask second = acquire_inline(waitable, slots[1]);
+     FrameTask third = acquire_queued(waitable, executor, slots[2]);
+     first.handle.resume();
+     second.handle.resume();
+     third.handle.resume();
+     TEST_ASSERT((waitable.waiting() == 3U) && !first.handle.done());
+     
+     /* The oldest waiter gets the block, resumed on its executor */
+     waitable.release(blocks[0]);
+     TEST_ASSERT((waitable.waiting() == 2U) && (slots[0] == nullptr) && (executor.ready.size() == 1U));
+     executor.run();
+     TEST_ASSERT(first.handle.done() && (slots[0] == blocks[0]));
+     
+     /* An inline waiter resumes inside release() */
+     waitable.release(blocks[1]);
+     TEST_ASSERT(second.handle.done() && (slots[1] == blocks[1]));
+     
+     /* Blocks go to waiters, not back to the pool, and nobody overtakes a waiter */
+     TEST_ASSERT(pool_get_free_count(&pool) == 0U);
+     waitable.release(blocks[2]);
+     executor.run();
+     TEST_ASSERT(third.handle.done() && (slots[2] == blocks[2]) && (waitable.waiting() == 0U));
+     
+     /* Without waiters a release returns the block to the pool */
+     waitable.release(slots[0]);
+     TEST_ASSERT(pool_get_free_count(&pool) == 1U);
+     FrameTask fourth = acquire_inline(waitable, slots[3]);
+     fourth.handle.resume();
+     TEST_ASSERT(fourth.handle.done() && (slots[3] == blocks[0]));
+ }
+ 
+ /**
+  * @brief Run the tests of the C++ interface
+  */
+ extern "C" void run_cpp_tests(void)
+ {
+     test_static_pool_small();
+     test_static_pool_wide();
+     test_pool_allocator();
+     test_pool_memory_resource();
+     test_object_pool();
+     test_pool_ptr();
+     test_pool_coro();
+     test_pool_await();
+ }
@@ -0,0 +1,137 @@
+/**
+ * @file        object_pool.hpp
+ * @brief       Typed C++ object pool with in-place construction
+ * @details     ObjectPool<T, N> keeps N objects of type T in a StaticPool whose
+ *              block size and alignment are sizeof(T) and alignof(T). create()
+ *              constructs an object in a free block, destroy() runs its destructor
+ *              and returns the block, so callers no longer pair placement new with
+ *              explicit destructor calls.
+ *
+ *              With live tracking (the default for types with a non-trivial
+ *              destructor) destroy() ignores pointers that are not live objects of
+ *              the pool and the pool destructor destroys the objects still alive.
+ *              Without it both reduce to the bare destructor call and block release.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "static_pool.hpp"
+
+/**
+ * @brief   Pool of N objects of type T
+ * @tparam  T           Object type
+ * @tparam  N           Number of objects
+ * @tparam  TrackLive   Validate destroy() and destroy leftover objects with the pool;
+ *                      off by default for trivially destructible types
+ */
+template <typename T, uintptr N, bool TrackLive = !std::is_trivially_destructible_v<T>>
+class ObjectPool
+{
+public:
+    using value_type = T;
+
+    static constexpr uintptr capacity = N;                  /**< Number of objects */
+    static constexpr bool tracks_live = TrackLive;          /**< Live tracking enabled */
+
+    constexpr ObjectPool() noexcept = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief  Destroy the objects still alive when live tracking is enabled
+     */
+    ~ObjectPool()
+    {
+        if constexpr (TrackLive && !std::is_trivially_destructible_v<T>)
+        {
+            pool_.for_each_allocated([](void* p_block) { std::launder(static_cast<T*>(p_block))->~T(); });
+        }
+    }
+
+    /**
+     * @brief  Construct an object in a free block
+     * @param  args  Constructor arguments
+     * @return Pointer to the new object, or nullptr if the pool is exhausted
+     * @note   If the constructor throws, the block is returned and the exception propagates
+     */
+    template <typename... Args>
+    T* create(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+    {
+        void* p_block = pool_.allocate();
+        if (p_block == nullptr) [[unlikely]]
+        {
+            return nullptr;
+        }
+
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+        {
+            return ::new (p_block) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            try
+            {
+                return ::new (p_block) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                pool_.deallocate_unchecked(p_block);
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief  Destroy an object and return its block
+     * @param  p_object  Object returned by create(), or nullptr
+     * @note   With live tracking, pointers that are not live objects of this pool
+     *         are ignored; without it p_object must be one
+     */
+    void destroy(T* p_object) noexcept
+    {
+        if constexpr (TrackLive)
+        {
+            if (!pool_.is_allocated(p_object)) [[unlikely]]
+            {
+                return;
+            }
+        }
+        else
+        {
+            if (p_object == nullptr)
+            {
+                return;
+            }
+        }
+        p_object->~T();
+        pool_.deallocate_unchecked(p_object);
+    }
+
+    /**
+     * @brief  Test whether a pointer is a live object of this pool
+     */
+    bool owns(const T* p_object) const noexcept
+    {
+        return pool_.is_allocated(p_object);
+    }
+
+    /**
+     * @brief  Number of objects that can still be created
+     */
+    auto free_count() const noexcept
+    {
+        return pool_.free_count();
+    }
+
+private:
+    StaticPool<sizeof(T), N, alignof(T)> pool_;     /**< Storage, one block per object */
+};
+
+#endif /* OBJECT_POOL_HPP */
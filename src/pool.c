@@ -6,129 +6,105 @@
  */
 
  #include "pool.h"
+ #include "pool_scrub.h"
+ #include "pool_reclaim.h"
+ #include "pool_quota.h"
+ #include "pool_os.h"
  #include "helper_routines.h"
- 
- /**
- * @brief Calculate the number of bytes needed for the allocation bitmap
- * @details The bitmap uses 1 bit per block to track allocation status (1 = allocated, 0 = free).
- *          This macro calculates the minimum number of bytes needed to store the bitmap.
- *          The formula (POOL_NUM_BLOCKS + 7) / 8 ensures we have enough bits by:
- *          1. Adding 7 to round up to the next full byte (since integer division truncates)
- *          2. Dividing by 8 to convert bits to bytes
- *          Example: For 10 blocks: (10 + 7) / 8 = 17/8 = 2.125 → 2 bytes (16 bits)
- *                   For 16 blocks: (16 + 7) / 8 = 23/8 = 2.875 → 2 bytes (16 bits)
- */
-#define BITMAP_BYTES ((POOL_NUM_BLOCKS + (BITS_PER_BYTE - 1U)) / BITS_PER_BYTE)
+ #include "compiler_abstraction.h"
  
 /**
- * @brief Set a specific bit in the allocation bitmap
- * @param bitmap Pointer to the bitmap array
- * @param index  Bit index to set (0-based)
- * 
- * @details This function sets the bit at the specified index in the bitmap to 1,
- *          indicating that the corresponding memory block is allocated.
- *          The function calculates the byte containing the target bit and the bit's
- *          position within that byte, then performs a bitwise OR operation to set it.
- * 
- * @note  - The bitmap uses 1 to indicate an allocated block
- *        - No bounds checking is performed on the index
+ * @brief Hook notified when the validated free path rejects a call (NULL = silent)
  */
- static void set_bit(uint8* bitmap, uint32 index) 
- {
-    uint32 byte_index = index / BITS_PER_BYTE;   /* Find which byte contains the bit */
-    uint32 bit_offset = index % BITS_PER_BYTE;   /* Find the bit's position within the byte */
-    bitmap[byte_index] |= (1U << bit_offset);  /* Set the bit using bitwise OR */
-}
- 
+static TPool_violation_hook violation_hook = NULL_PTR;
+
 /**
- * @brief Clear a specific bit in the allocation bitmap
- * @param bitmap Pointer to the bitmap array
- * @param index  Bit index to clear (0-based)
- * 
- * @details This function clears the bit at the specified index in the bitmap to 0,
- *          indicating that the corresponding memory block is free.
- *          The function calculates the byte containing the target bit and the bit's
- *          position within that byte, then performs a bitwise AND with the inverse
- *          of the bitmask to clear it.
- * 
- * @note  - The bitmap uses 0 to indicate a free block
- *        - No bounds checking is performed on the index
+ * @brief Report a rejected free to the registered violation hook
+ * @param p_handle  Pool handle passed by the caller
+ * @param p_block   Block pointer passed by the caller
+ * @param violation Kind of violation detected
+ *
+ * @note  Kept out-of-line and cold so the validation branches in pool_free()
+ *        stay cheap when the arguments are valid.
  */
- static void clear_bit(uint8* bitmap, uint32 index)
+static ATTR_COLD ATTR_NOINLINE void report_violation(const TPool_handle* p_handle, const void* p_block, TPool_violation violation)
 {
-    uint32 byte_index = index / BITS_PER_BYTE;       /* Find which byte contains the bit */
-    uint32 bit_offset = index % BITS_PER_BYTE;       /* Find the bit's position within the byte */
-    uint8  mask = (uint8)(1U << bit_offset);         /* Create mask for target bit */
-    bitmap[byte_index] &= ~mask;                     /* Clear the bit using bitwise AND with inverted mask */
+    if (NULL_PTR != violation_hook)
+    {
+        violation_hook(p_handle, p_block, violation);
+    }
 }
  
 /**
- * @brief Test if a specific bit in the allocation bitmap is set
- * @param bitmap Pointer to the bitmap array
- * @param index  Bit index to test (0-based)
- * @return uint8 Returns 1 if the bit is set (allocated), 0 if clear (free)
- * 
- * @details This function checks the value of the bit at the specified index
- *          in the bitmap. The function calculates the byte containing the target
- *          bit and the bit's position within that byte, then extracts and returns
- *          the bit's value.
- * 
- * @note  - The bitmap uses 1 to indicate an allocated block
- *        - No bounds checking is performed on the index
- *        - The return value is always 0 or 1
- */
- static uint8 test_bit(const uint8* bitmap, uint32 index) 
- {
-    uint32 byte_index = index / BITS_PER_BYTE;       /* Find which byte contains the bit */
-    uint32 bit_offset = index % BITS_PER_BYTE;       /* Find the bit's position within the byte */
-    return (bitmap[byte_index] >> bit_offset) & 1U;  /* Return the bit value (0 or 1) */
-}
- 
- /**
- * @brief Find the first free block in the bitmap
+ * @brief Initialize the static memory pool
  * 
- * @param bitmap Pointer to the bitmap array where each bit represents a block
- * @param num_blocks Total number of blocks to check in the bitmap
- * @return int32 Index of the first free block (0 to num_blocks-1) if found,
- *         -1 if no free blocks are available
+ * @param p_handle Pointer to the pool handle structure to be initialized
  * 
- * @note  - The function scans the bitmap from the start until it finds
- *           the first clear bit (0) indicating a free block
- *        - The search is linear and stops at the first available block
- *        - Thread safety must be handled by the caller if used in a multi-threaded context
+ * @note  - The function initializes all bytes of the pool handle to zero
+ *        - This includes both the bitmap and the memory pool itself
+ *        - If p_handle is NULL, the function returns without taking any action
+ *        - This function should be called before any other pool operations
  */
- static sint32 find_first_free(const uint8* bitmap, uint32 num_blocks) 
+ void pool_init(TPool_handle* p_handle) 
  {
-     uint32 i;
-     for (i = 0U; i < num_blocks; i++) 
-     {
-         if (0U == test_bit(bitmap, i)) 
-         {
-             return (sint32)i;
-         }
-     }
-
-     return -1;  /* No free block found */
+     pool_init_ex(p_handle, POOL_INIT_FULL);
  }
  
 /**
- * @brief Initialize the static memory pool
+ * @brief Initialize the static memory pool with a selectable scope
  * 
  * @param p_handle Pointer to the pool handle structure to be initialized
+ * @param mode     Which parts of the handle to reset
  * 
- * @note  - The function initializes all bytes of the pool handle to zero
- *        - This includes both the bitmap and the memory pool itself
+ * @note  - POOL_INIT_FULL zeroes all bytes of the handle, memory area included
+ *        - POOL_INIT_METADATA marks every block free without writing the memory
+ *          area, so pages of a loader-zeroed pool that were never touched stay
+ *          unbacked and start-up cost is proportional to the bitmap size only
+ *        - POOL_INIT_ZEROED does the same and additionally records that the memory
+ *          area is all zero, so pool_alloc_zeroed() does not clear any block until
+ *          it has been handed out once
  *        - If p_handle is NULL, the function returns without taking any action
- *        - This function should be called before any other pool operations
+ *        - A running scrubber must be stopped before the pool is re-initialized
+ *        - POOL_INIT_METADATA and POOL_INIT_ZEROED keep the lock and wait state of
+ *          POOL_WAIT; no thread may use or wait on the pool during the call
+ *        - They also keep the watermarks of POOL_WATERMARKS; a pool above the high
+ *          watermark signals its fall to empty. POOL_INIT_FULL disables them.
+ *        - Reclaim hooks of POOL_RECLAIM are kept the same way
+ *        - So are the classes and the reserve of POOL_QUOTA; their charges are dropped
  */
- void pool_init(TPool_handle* p_handle) 
+ void pool_init_ex(TPool_handle* p_handle, TPool_init_mode mode)
  {
      /* Check for NULL pointer */
-     if (NULL_PTR != p_handle)
+     if (NULL_PTR == p_handle)
+     {
+         return;
+     }
+     
+     if (POOL_INIT_FULL == mode)
      {
          /* Initialize all bytes of the pool handle to zero */
          mem_set(p_handle, 0U, sizeof(TPool_handle));
+         return;
      }
+     
+     mem_set(p_handle->bitmap, 0U, sizeof(p_handle->bitmap));
+     p_handle->hint = 0U;
+     p_handle->used = 0U;
+     p_handle->zero_mark = (POOL_INIT_ZEROED == mode) ? 0U : (TPool_index)POOL_NUM_BLOCKS;
+ #if (POOL_SCRUB == STD_ON)
+     /* Queued blocks are free again; the lists point into the memory area */
+     p_handle->scrub.dirty_head = NULL_PTR;
+     p_handle->scrub.clean_head = NULL_PTR;
+     p_handle->scrub.dirty_count = 0U;
+     p_handle->scrub.clean_count = 0U;
+     mem_set(p_handle->scrub.pending, 0U, sizeof(p_handle->scrub.pending));
+ #endif
+ #if (POOL_WATERMARKS == STD_ON)
+     pool_watermark_reset(p_handle);
+ #endif
+ #if (POOL_QUOTA == STD_ON)
+     pool_quota_reset(p_handle);
+ #endif
  }
  
 /**
@@ -144,30 +120,116 @@
  */
  void* pool_alloc(TPool_handle* p_handle) 
  {
-     sint32 block_index;
-     
      /* Check for NULL pointer */
      if (NULL_PTR == p_handle)
      {
          return NULL_PTR;
      }
      
-     /* Find the first available block */
-     block_index = find_first_free(p_handle->bitmap, POOL_NUM_BLOCKS);
+     return pool_alloc_fast(p_handle);
+ }
+ 
+/**
+ * @brief Allocation path taken when the word at the search hint is full
+ * 
+ * @param p_handle Pointer to the initialized pool handle
+ * @return void*   Pointer to the allocated block, or NULL if no free blocks are available
+ * 
+ * @note  - Scans the bitmap forward from the hint for the first free block
+ *        - Advances the hint to the word holding that block, so the next
+ *          allocations hit the fast path again
+ *        - When the pool is exhausted the hint is left on the last word
+ *        - With POOL_SCRUB == STD_ON scrubbed blocks are collected before giving up
+ *        - With POOL_RECLAIM == STD_ON the reclaim hooks run before giving up
+ */
+ void* pool_alloc_slow(TPool_handle* p_handle)
+ {
+     uintptr block_index;
+     
+     /* Find the first available block at or after the hint */
+     block_index = pool_bitmap_find_free(p_handle->bitmap, POOL_NUM_BLOCKS, p_handle->hint);
+     
+ #if (POOL_SCRUB == STD_ON)
+     /* Prefer clean blocks; they come back only through the scrubber */
+     if ((block_index >= POOL_NUM_BLOCKS) && (TRUE == pool_scrub_collect(p_handle)))
+     {
+         block_index = pool_bitmap_find_free(p_handle->bitmap, POOL_NUM_BLOCKS, p_handle->hint);
+     }
+ #endif
+     
+ #if (POOL_RECLAIM == STD_ON)
+     /* Ask the caches built on the pool to give blocks back, then retry once */
+     if ((block_index >= POOL_NUM_BLOCKS) && (TRUE == pool_reclaim_run(p_handle)))
+     {
+         block_index = pool_bitmap_find_free(p_handle->bitmap, POOL_NUM_BLOCKS, p_handle->hint);
+ #if (POOL_SCRUB == STD_ON)
+         if ((block_index >= POOL_NUM_BLOCKS) && (TRUE == pool_scrub_collect(p_handle)))
+         {
+             block_index = pool_bitmap_find_free(p_handle->bitmap, POOL_NUM_BLOCKS, p_handle->hint);
+         }
+ #endif
+         p_handle->reclaim.rescues += (block_index < POOL_NUM_BLOCKS) ? 1U : 0U;
+     }
+ #endif
      
      /* Check if a free block was found */
-     if (block_index < 0)
+     if (block_index >= POOL_NUM_BLOCKS)
      {
+         p_handle->hint = (TPool_index)(POOL_BITMAP_WORDS - 1U);
          return NULL_PTR;  /* No free blocks available */
      }
      
      /* Mark the block as used */
-     set_bit(p_handle->bitmap, (uint32)block_index);
+     p_handle->hint = (TPool_index)(block_index / POOL_WORD_BITS);
+     pool_bit_set(p_handle->bitmap, block_index);
+     p_handle->used++;
+     if (block_index >= p_handle->zero_mark)
+     {
+         p_handle->zero_mark = (TPool_index)(block_index + 1U);
+     }
+ #if (POOL_WATERMARKS == STD_ON)
+     pool_watermark_check(p_handle);
+ #endif
      
      /* Return pointer to the allocated block */
      return &p_handle->memory[block_index * POOL_BLOCK_SIZE];
  }
  
+/**
+ * @brief Allocate a zero-filled block from the memory pool
+ * 
+ * @param p_handle Pointer to the initialized pool handle
+ * @return void*   Pointer to the zero-filled block, or NULL if allocation fails
+ * 
+ * @note  - Returns NULL if p_handle is NULL or no free blocks are available
+ *        - Blocks at or above the zero watermark have not been handed out since the
+ *          memory area was zeroed and are returned without clearing
+ *        - Blocks below it are cleared with pool_block_zero()
+ *        - Thread safety must be handled by the caller if used in a multi-threaded context
+ */
+ void* pool_alloc_zeroed(TPool_handle* p_handle)
+ {
+     TPool_index zero_mark;
+     uint8* block;
+     
+     /* Check for NULL pointer */
+     if (NULL_PTR == p_handle)
+     {
+         return NULL_PTR;
+     }
+     
+     zero_mark = p_handle->zero_mark;
+     block = (uint8*)pool_alloc_fast(p_handle);
+     
+     /* Clear only blocks that may have been written since the last zeroing */
+     if ((NULL_PTR != block) && (((uintptr)(block - p_handle->memory) / POOL_BLOCK_SIZE) < zero_mark))
+     {
+         pool_block_zero(block);
+     }
+     
+     return block;
+ }
+ 
  /**
  * @brief Free a previously allocated block back to the memory pool
  * 
@@ -183,83 +245,304 @@
  *          - Input parameters are not NULL
  *          - The pointer is within the pool's memory range
  *          - The pointer is properly aligned
- *          - The block index is within valid range
+ *          - The block is currently allocated
+ *        - Every rejected call is reported to the hook set by pool_set_violation_hook()
+ *        - Runs pool_trim() when the free count reaches the trim threshold
+ *        - With POOL_SCRUB == STD_ON the block is queued for zeroing instead of being
+ *          returned to the free set directly
+ *        - With POOL_WAIT == STD_ON a thread sleeping in pool_alloc_wait() is woken
+ *        - With POOL_WATERMARKS == STD_ON a fall to the low watermark is signalled
  */
 void pool_free(TPool_handle* p_handle, void* p_block) 
 {
-    uint32 block_index;
+    uintptr block_offset;
+    uintptr block_index;
     uint8* pool_start;
     uint8* pool_end;
     
     /* Check for NULL pointers */
-    if (NULL_PTR == p_handle || NULL_PTR == p_block)
+    if (UNLIKELY(NULL_PTR == p_handle))
     {
+        report_violation(p_handle, p_block, POOL_VIOLATION_NULL_HANDLE);
+        return;
+    }
+    
+    if (UNLIKELY(NULL_PTR == p_block))
+    {
+        report_violation(p_handle, p_block, POOL_VIOLATION_NULL_BLOCK);
         return;
     }
     
     /* Calculate pool memory boundaries */
     pool_start = p_handle->memory;
-    pool_end = pool_start + (POOL_NUM_BLOCKS * POOL_BLOCK_SIZE);
+    pool_end = pool_start + sizeof(p_handle->memory);
     
     /* Check if pointer is within pool bounds */
-    if (p_block < (void*)pool_start || p_block >= (void*)pool_end) 
+    if (UNLIKELY(p_block < (void*)pool_start || p_block >= (void*)pool_end)) 
     {
+        report_violation(p_handle, p_block, POOL_VIOLATION_OUT_OF_RANGE);
         return;  /* Invalid pointer - not from this pool */
     }
     
-    /* Calculate block index */
-    block_index = ((uint8*)p_block - pool_start) / POOL_BLOCK_SIZE;
-    
-    /* Validate alignment and block boundary */
-    if (((uint8*)p_block - pool_start) % POOL_BLOCK_SIZE != 0) 
+    /* Validate alignment and block boundary; the range check above already
+     * guarantees that the resulting block index is below POOL_NUM_BLOCKS */
+    block_offset = (uintptr)((uint8*)p_block - pool_start);
+    if (UNLIKELY((block_offset % POOL_BLOCK_SIZE) != 0U)) 
     {
+        report_violation(p_handle, p_block, POOL_VIOLATION_MISALIGNED);
         return;  /* Not aligned to block boundary */
     }
     
-    /* Validate block index */
-    if (block_index >= POOL_NUM_BLOCKS)
+    /* Only clear if it was allocated (defensive programming) */
+    block_index = block_offset / POOL_BLOCK_SIZE;
+    if (UNLIKELY(0U == pool_bit_test(p_handle->bitmap, block_index)))
+    {
+        report_violation(p_handle, p_block, POOL_VIOLATION_DOUBLE_FREE);
+        return;
+    }
+    
+#if (POOL_SCRUB == STD_ON)
+    /* Queued blocks keep their bitmap bit until they are scrubbed */
+    if (UNLIKELY(TRUE == pool_scrub_is_pending(p_handle, block_index)))
     {
-        return;  /* Block index out of range */
+        report_violation(p_handle, p_block, POOL_VIOLATION_DOUBLE_FREE);
+        return;
     }
     
-    /* Only clear if it was allocated (defensive programming) */
-    if (test_bit(p_handle->bitmap, block_index))
+    p_handle->used--;
+    pool_scrub_defer(p_handle, block_index);
+#else
+    pool_bit_clear(p_handle->bitmap, block_index);
+    p_handle->used--;
+    
+    /* Keep the invariant that every word below the hint is full */
+    if ((block_index / POOL_WORD_BITS) < p_handle->hint)
     {
-        clear_bit(p_handle->bitmap, block_index);
+        p_handle->hint = (TPool_index)(block_index / POOL_WORD_BITS);
     }
+#endif
+    
+#if (POOL_WATERMARKS == STD_ON)
+    pool_watermark_check(p_handle);
+#endif
+    
+    /* Automatic trim when the free count climbs to the threshold */
+    if (UNLIKELY((POOL_NUM_BLOCKS - p_handle->used) == p_handle->trim_free))
+    {
+        (void)pool_trim(p_handle);
+    }
+    
+#if (POOL_WAIT == STD_ON)
+    /* Enter the kernel only if a thread sleeps in pool_alloc_wait() */
+    if (UNLIKELY(0U != p_handle->wait.waiters))
+    {
+        pool_wait_wake(p_handle);
+    }
+#endif
+}
+ 
+/**
+ * @brief Release the physical pages of fully free runs of blocks
+ * 
+ * @param p_handle Pointer to the initialized pool handle
+ * @return TPool_size Number of bytes released to the operating system
+ * 
+ * @note  - Walks the runs of free blocks in the bitmap and releases every whole
+ *          page inside a run; pages shared with an allocated block are kept
+ *        - Released blocks stay free and keep their addresses; the next write
+ *          faults in a fresh page
+ *        - POOL_TRIM_LAZY selects MADV_FREE instead of MADV_DONTNEED
+ *        - Returns 0 if p_handle is NULL or the target has no paged virtual memory
+ *        - Every other call is counted in trim_runs of pool_get_stats()
+ *        - Thread safety must be handled by the caller if used in a multi-threaded context
+ */
+ TPool_size pool_trim(TPool_handle* p_handle)
+ {
+     uintptr page_size = pool_os_page_size();
+     TPool_size released = 0U;
+     uintptr run_start;
+     uintptr run_end = 0U;
+     
+     if ((NULL_PTR == p_handle) || (0U == page_size))
+     {
+         return 0U;
+     }
+     
+     p_handle->trim_runs++;
+     for (;;)
+     {
+         uintptr first_page;
+         uintptr last_page;
+         
+         run_start = pool_bitmap_next(p_handle->bitmap, POOL_NUM_BLOCKS, run_end, 0U);
+         if (run_start >= POOL_NUM_BLOCKS)
+         {
+             break;
+         }
+         run_end = pool_bitmap_next(p_handle->bitmap, POOL_NUM_BLOCKS, run_start, 1U);
+         
+         /* Whole pages inside [run_start, run_end) */
+         first_page = ((uintptr)&p_handle->memory[run_start * POOL_BLOCK_SIZE] + (page_size - 1U)) & ~(page_size - 1U);
+         last_page = (uintptr)&p_handle->memory[run_end * POOL_BLOCK_SIZE] & ~(page_size - 1U);
+         
+         if ((last_page > first_page) &&
+             (STD_OK == pool_os_release((void*)first_page, last_page - first_page, (boolean)(POOL_TRIM_LAZY == STD_ON))))
+         {
+             released += (TPool_size)(last_page - first_page);
+         }
+     }
+     
+     return released;
+ }
+ 
+/**
+ * @brief Make the whole memory area of the pool resident before use
+ * 
+ * @param p_handle    Pointer to the initialized pool handle
+ * @param lock_pages  TRUE to lock the pages with mlock() afterwards
+ * @param num_threads Maximum number of threads faulting in pages in parallel
+ * @return Std_ReturnType STD_OK if every page is resident (and locked)
+ * 
+ * @note  - Every page is faulted in for writing, so the first access to a block
+ *          at request time no longer takes a page fault
+ *        - Large pools are split across up to num_threads threads
+ *        - Locking fails if it exceeds RLIMIT_MEMLOCK; the pages stay resident
+ *        - Pages released with pool_trim() afterwards need another prefault
+ */
+ Std_ReturnType pool_prefault(TPool_handle* p_handle, boolean lock_pages, uint32 num_threads)
+ {
+     if (NULL_PTR == p_handle)
+     {
+         return STD_NOT_OK;
+     }
+     
+     if (STD_OK != pool_os_populate(p_handle->memory, sizeof(p_handle->memory), num_threads))
+     {
+         return STD_NOT_OK;
+     }
+     
+     if (TRUE == lock_pages)
+     {
+         return pool_os_lock(p_handle->memory, sizeof(p_handle->memory));
+     }
+     
+     return STD_OK;
+ }
+ 
+/**
+ * @brief Place the memory area of the pool on one NUMA node
+ * 
+ * @param p_handle Pointer to the pool handle
+ * @param node     NUMA node number
+ * @return Std_ReturnType STD_OK if the memory area is bound to the node
+ * 
+ * @note  - Uses mbind() through the raw syscall, libnuma is not required
+ *        - Only whole pages of the memory area are bound; the partial pages at its
+ *          ends are shared with neighbouring data and keep their policy
+ *        - Pages already resident are migrated when they are not shared
+ *        - Returns STD_NOT_OK for a node that does not exist and on targets
+ *          without NUMA support; the pool stays usable either way
+ */
+ Std_ReturnType pool_bind_node(TPool_handle* p_handle, uint32 node)
+ {
+     if (NULL_PTR == p_handle)
+     {
+         return STD_NOT_OK;
+     }
+     
+     return pool_os_numa_bind(p_handle->memory, sizeof(p_handle->memory), node);
+ }
+ 
+/**
+ * @brief Trim the pool automatically when the free count climbs to a threshold
+ * 
+ * @param p_handle    Pointer to the initialized pool handle
+ * @param free_blocks Free count at which pool_free() runs pool_trim(), 0 to disable
+ * 
+ * @note  - The trim runs on the free that makes the free count equal to the
+ *          threshold, i.e. once per upward crossing
+ *        - The check on the free path is a single compare
+ */
+ void pool_set_trim_threshold(TPool_handle* p_handle, TPool_index free_blocks)
+ {
+     if (NULL_PTR != p_handle)
+     {
+         p_handle->trim_free = (free_blocks <= POOL_NUM_BLOCKS) ? free_blocks : (TPool_index)POOL_NUM_BLOCKS;
+     }
+ }
+ 
+/**
+ * @brief Register the hook called when pool_free() rejects a call
+ * 
+ * @param hook Callback to register, or NULL to reject invalid calls silently
+ * 
+ * @note  - The hook is shared by all pools
+ *        - The hook runs on the thread that made the rejected call
+ */
+void pool_set_violation_hook(TPool_violation_hook hook)
+{
+    violation_hook = hook;
 }
  
 /**
  * @brief Get the number of free blocks in the memory pool
  * 
  * @param p_handle Pointer to the initialized pool handle
- * @return uint32  Number of free blocks available for allocation
+ * @return TPool_index Number of free blocks available for allocation
  * 
  * @note  - Returns 0 if p_handle is NULL
- *        - The function scans the entire bitmap to count free blocks
- *        - The returned count represents the number of blocks that can be allocated
- *        - Time complexity is O(n) where n is POOL_NUM_BLOCKS
+ *        - The count is derived from the number of allocated blocks kept in the handle
+ *        - Time complexity is O(1)
  *        - Thread safety must be handled by the caller if used in a multi-threaded context
  */
- uint32 pool_get_free_count(const TPool_handle* p_handle) 
+ TPool_index pool_get_free_count(const TPool_handle* p_handle) 
  {
-     uint32 i;
-     uint32 free_count = 0U;
-     
      /* Check for NULL pointer */
      if (NULL_PTR == p_handle)
      {
          return 0U;
      }
      
-     /* Count all free blocks */
-     for (i = 0U; i < POOL_NUM_BLOCKS; i++)
+     return (TPool_index)(POOL_NUM_BLOCKS - p_handle->used);
+ }
+ 
+/**
+ * @brief Get a snapshot of the pool usage
+ * 
+ * @param p_handle Pointer to the initialized pool handle
+ * @param p_stats  Pointer to the structure receiving the snapshot
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK if a parameter is NULL
+ * 
+ * @note  - dirty_count and clean_count are the scrubber backlog; both are 0
+ *          with POOL_SCRUB == STD_OFF
+ *        - The backlog counters are updated by the worker thread, so they are
+ *          only a momentary view while it runs
+ *        - reclaim_runs and reclaim_rescues are 0 with POOL_RECLAIM == STD_OFF
+ */
+ Std_ReturnType pool_get_stats(const TPool_handle* p_handle, TPool_stats* p_stats)
+ {
+     if ((NULL_PTR == p_handle) || (NULL_PTR == p_stats))
      {
-         if (!test_bit(p_handle->bitmap, i))
-         {
-             free_count++;
-         }
+         return STD_NOT_OK;
      }
      
-     return free_count;
- }
\ No newline at end of file
+     p_stats->used_count = p_handle->used;
+     p_stats->free_count = (TPool_index)(POOL_NUM_BLOCKS - p_handle->used);
+     p_stats->trim_runs = p_handle->trim_runs;
+ #if (POOL_SCRUB == STD_ON)
+     p_stats->dirty_count = __atomic_load_n(&p_handle->scrub.dirty_count, __ATOMIC_RELAXED);
+     p_stats->clean_count = __atomic_load_n(&p_handle->scrub.clean_count, __ATOMIC_RELAXED);
+ #else
+     p_stats->dirty_count = 0U;
+     p_stats->clean_count = 0U;
+ #endif
+ #if (POOL_RECLAIM == STD_ON)
+     p_stats->reclaim_runs = p_handle->reclaim.runs;
+     p_stats->reclaim_rescues = p_handle->reclaim.rescues;
+ #else
+     p_stats->reclaim_runs = 0U;
+     p_stats->reclaim_rescues = 0U;
+ #endif
+     
+     return STD_OK;
+ }
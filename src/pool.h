@@ -13,6 +13,23 @@
 #define POOL_H
 
 #include "pool_types.h"
+#include "pool_bitmap.h"
+#include "pool_wait.h"
+#include "pool_watermark.h"
+#include "helper_routines.h"
+#include "compiler_abstraction.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Constant initializer for pools in static storage
+ * @details A handle defined as `static TPool_handle pool = POOL_STATIC_INIT;` is
+ *          ready for use without calling pool_init(). The initializer is all zero,
+ *          so the handle stays in .bss and its pages are only backed once touched.
+ */
+#define POOL_STATIC_INIT    { 0 }
 
 /**
  * @brief   Initialize the static memory pool
@@ -24,6 +41,18 @@
  */
 void pool_init(TPool_handle* p_handle);
 
+/**
+ * @brief   Initialize the static memory pool with a selectable scope
+ * @param   p_handle   Pointer to the pool handle to be initialized
+ * @param   mode       POOL_INIT_FULL behaves like pool_init(); POOL_INIT_METADATA
+ *                     and POOL_INIT_ZEROED reset only the bitmap and counters in
+ *                     O(metadata)
+ * @return  None
+ * @post    Pool is ready for allocation requests
+ * @note    If p_handle is NULL, the function returns without taking any action
+ */
+void pool_init_ex(TPool_handle* p_handle, TPool_init_mode mode);
+
 /**
  * @brief   Allocate a block from the memory pool
  * @param   p_handle    Pointer to the pool handle
@@ -33,6 +62,17 @@ void pool_init(TPool_handle* p_handle);
  */
 void* pool_alloc(TPool_handle* p_handle);
 
+/**
+ * @brief   Allocate a zero-filled block from the memory pool
+ * @param   p_handle    Pointer to the pool handle
+ * @return  Pointer to the allocated block, or NULL if no blocks available
+ * @pre     Pool must be initialized
+ * @post    If successful, a block of size POOL_BLOCK_SIZE filled with zero is allocated
+ * @note    Only blocks that were handed out before are cleared; blocks that are
+ *          still zero since the last zeroing init are returned as they are
+ */
+void* pool_alloc_zeroed(TPool_handle* p_handle);
+
 /**
  * @brief   Free a previously allocated block back to the pool
  * @param   p_handle    Pointer to the pool handle
@@ -43,13 +83,174 @@ void* pool_alloc(TPool_handle* p_handle);
  */
 void pool_free(TPool_handle* p_handle, void* p_block);
 
+/**
+ * @brief   Register the hook called when pool_free() rejects a call
+ * @param   hook    Callback to register, or NULL to return to silent rejection
+ * @return  None
+ */
+void pool_set_violation_hook(TPool_violation_hook hook);
+
 /**
  * @brief   Get the number of free blocks in the pool
  * @param   p_handle    Pointer to the pool handle
  * @return  Number of free blocks available
  * @pre     Pool must be initialized
  */
-uint32 pool_get_free_count(const TPool_handle* p_handle);
+TPool_index pool_get_free_count(const TPool_handle* p_handle);
+
+/**
+ * @brief   Get a snapshot of the pool usage
+ * @param   p_handle    Pointer to the pool handle
+ * @param   p_stats     Pointer to the structure receiving the snapshot
+ * @return  STD_OK on success, STD_NOT_OK if a parameter is NULL
+ * @pre     Pool must be initialized
+ */
+Std_ReturnType pool_get_stats(const TPool_handle* p_handle, TPool_stats* p_stats);
+
+/**
+ * @brief   Release the physical pages of fully free runs of blocks
+ * @param   p_handle    Pointer to the pool handle
+ * @return  Number of bytes released to the operating system
+ * @pre     Pool must be initialized
+ * @post    Free blocks keep their addresses; their contents become undefined
+ * @note    Returns 0 without paged virtual memory or if p_handle is NULL
+ */
+TPool_size pool_trim(TPool_handle* p_handle);
+
+/**
+ * @brief   Trim the pool automatically when the free count climbs to a threshold
+ * @param   p_handle    Pointer to the pool handle
+ * @param   free_blocks Free count at which a free runs pool_trim(), 0 to disable
+ * @return  None
+ */
+void pool_set_trim_threshold(TPool_handle* p_handle, TPool_index free_blocks);
+
+/**
+ * @brief   Make the whole memory area of the pool resident before use
+ * @param   p_handle    Pointer to the pool handle
+ * @param   lock_pages  TRUE to also lock the pages into physical memory (mlock)
+ * @param   num_threads Maximum number of threads faulting in pages in parallel
+ * @return  STD_OK if every page is resident (and locked), STD_NOT_OK otherwise
+ * @pre     No other thread may use the pool during the call
+ * @note    Block contents are preserved
+ */
+Std_ReturnType pool_prefault(TPool_handle* p_handle, boolean lock_pages, uint32 num_threads);
+
+/**
+ * @brief   Place the memory area of the pool on one NUMA node
+ * @param   p_handle    Pointer to the pool handle
+ * @param   node        NUMA node number
+ * @return  STD_OK if the memory area is bound to the node, STD_NOT_OK otherwise
+ * @note    Call before pool_prefault() so that the pages are faulted in on the node.
+ *          Only whole pages of the memory area are bound, so a handle meant for one
+ *          node should be page aligned (e.g. ATTR_ALIGNED(4096)) and not share its
+ *          pages with pools bound to other nodes.
+ */
+Std_ReturnType pool_bind_node(TPool_handle* p_handle, uint32 node);
+
+/**
+ * @brief   Out-of-line allocation path used when the fast path misses
+ * @param   p_handle    Pointer to the pool handle, must not be NULL
+ * @return  Pointer to the allocated block, or NULL if no blocks available
+ * @note    Called by pool_alloc_fast() only; applications use pool_alloc()
+ */
+ATTR_COLD void* pool_alloc_slow(TPool_handle* p_handle);
+
+/**
+ * @brief   Allocate a block on a trusted call path (inlined)
+ * @param   p_handle    Pointer to the pool handle, must not be NULL
+ * @return  Pointer to the allocated block, or NULL if no blocks available
+ * @pre     Pool must be initialized
+ * @post    If successful, a block of size POOL_BLOCK_SIZE is allocated
+ * @note    The hit path takes the lowest free bit of the bitmap word at the
+ *          search hint. It calls pool_alloc_slow() only when that word is full.
+ */
+LOCAL_INLINE void* pool_alloc_fast(TPool_handle* p_handle)
+{
+    uintptr word_index = p_handle->hint;
+    TPool_word free_bits = (TPool_word)~p_handle->bitmap[word_index];
+    uintptr block_index = (word_index * POOL_WORD_BITS) + pool_word_ctz(free_bits | ((TPool_word)1U << (POOL_WORD_BITS - 1U)));
+
+    if (LIKELY((0U != free_bits) && (block_index < POOL_NUM_BLOCKS)))
+    {
+        p_handle->bitmap[word_index] |= free_bits & (TPool_word)(~free_bits + 1U);  /* Lowest free bit */
+        p_handle->used++;
+        p_handle->zero_mark = (block_index < p_handle->zero_mark) ? p_handle->zero_mark : (TPool_index)(block_index + 1U);
+#if (POOL_WATERMARKS == STD_ON)
+        pool_watermark_check(p_handle);
+#endif
+        return &p_handle->memory[block_index * POOL_BLOCK_SIZE];
+    }
+
+    return pool_alloc_slow(p_handle);
+}
+
+/**
+ * @brief   Free a block without validation on trusted call paths (inlined)
+ * @param   p_handle    Pointer to the pool handle
+ * @param   p_block     Pointer to the block to free
+ * @return  None
+ * @pre     p_block must be a block returned by pool_alloc() on the same p_handle
+ * @post    The block is returned to the pool and can be reused
+ * @note    With POOL_HARDENED == STD_ON or POOL_SCRUB == STD_ON this behaves
+ *          exactly like pool_free()
+ */
+LOCAL_INLINE void pool_free_fast(TPool_handle* p_handle, void* p_block)
+{
+#if (POOL_HARDENED == STD_ON) || (POOL_SCRUB == STD_ON)
+    pool_free(p_handle, p_block);
+#else
+    uintptr block_index = (uintptr)((uint8*)p_block - p_handle->memory) / POOL_BLOCK_SIZE;
+    uintptr word_index = block_index / POOL_WORD_BITS;
+    TPool_word word = p_handle->bitmap[word_index];
+
+    p_handle->bitmap[word_index] = word & ~((TPool_word)1U << (block_index % POOL_WORD_BITS));
+    p_handle->used -= (TPool_index)((word >> (block_index % POOL_WORD_BITS)) & 1U);  /* Freeing a free block is a no-op */
+    p_handle->hint = (word_index < p_handle->hint) ? (TPool_index)word_index : p_handle->hint;
+
+#if (POOL_WATERMARKS == STD_ON)
+    pool_watermark_check(p_handle);
+#endif
+
+    if (UNLIKELY((POOL_NUM_BLOCKS - p_handle->used) == p_handle->trim_free))
+    {
+        (void)pool_trim(p_handle);
+    }
+#if (POOL_WAIT == STD_ON)
+    if (UNLIKELY(0U != p_handle->wait.waiters))
+    {
+        pool_wait_wake(p_handle);
+    }
+#endif
+#endif
+}
+
+/**
+ * @brief   Zero one pool block
+ * @param   p_block     Pointer to a block of this pool
+ * @return  None
+ * @note    Specialized at compile time for POOL_BLOCK_SIZE: the size is a
+ *          constant, so the kernel unrolls into straight vector or word stores
+ */
+LOCAL_INLINE void pool_block_zero(void* p_block)
+{
+    mem_zero_fixed(p_block, POOL_BLOCK_SIZE);
+}
+
+/**
+ * @brief   Copy the contents of one pool block to another
+ * @param   p_dest      Pointer to the destination block
+ * @param   p_src       Pointer to the source block
+ * @return  None
+ * @note    Specialized at compile time for POOL_BLOCK_SIZE, see pool_block_zero()
+ */
+LOCAL_INLINE void pool_block_copy(void* p_dest, const void* p_src)
+{
+    mem_copy_fixed(p_dest, p_src, POOL_BLOCK_SIZE);
+}
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* POOL_H */
\ No newline at end of file
@@ -0,0 +1,263 @@
+/**
+ * @file        pool_allocator.hpp
+ * @brief       Standard library allocator adapters over the memory pool
+ * @details     PoolAllocator<T> satisfies the Allocator requirements and
+ *              basic_pool_memory_resource derives from std::pmr::memory_resource.
+ *              Both serve requests that fit one block from a pool and pass every
+ *              other request, and requests the exhausted pool cannot serve, upstream.
+ *              Node containers (std::list, std::map, std::unordered_map nodes) thus
+ *              take their nodes from the pool.
+ *
+ *              The pool is a TPool_handle (through pool_alloc_fast()/pool_free_fast())
+ *              by default; a StaticPool<> can be used instead through pool_traits.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include "pool.h"
+#include "static_pool.hpp"
+
+/**
+ * @brief   Uniform access to the pools usable by the allocator adapters
+ * @details Specializations provide block_size, block_align and static
+ *          allocate(), deallocate() and owns() functions.
+ */
+template <typename Pool>
+struct pool_traits;
+
+/**
+ * @brief   pool_traits for the C pool configured in pool_cfg.h
+ */
+template <>
+struct pool_traits<TPool_handle>
+{
+    static constexpr uintptr block_size = POOL_BLOCK_SIZE;
+    static constexpr uintptr block_align = ((POOL_BLOCK_SIZE & (~POOL_BLOCK_SIZE + 1U)) < POOL_MEMORY_ALIGN)
+                                           ? (POOL_BLOCK_SIZE & (~POOL_BLOCK_SIZE + 1U)) : POOL_MEMORY_ALIGN;
+
+    static void* allocate(TPool_handle& pool) noexcept
+    {
+        return pool_alloc_fast(&pool);
+    }
+
+    static void deallocate(TPool_handle& pool, void* p_block) noexcept
+    {
+        pool_free_fast(&pool, p_block);
+    }
+
+    static bool owns(const TPool_handle& pool, const void* p_block) noexcept
+    {
+        return (reinterpret_cast<uintptr>(p_block) - reinterpret_cast<uintptr>(&pool.memory[0])) < sizeof(pool.memory);
+    }
+};
+
+/**
+ * @brief   pool_traits for StaticPool
+ */
+template <uintptr BlockSize, uintptr N, uintptr Align>
+struct pool_traits<StaticPool<BlockSize, N, Align>>
+{
+    static constexpr uintptr block_size = BlockSize;
+    static constexpr uintptr block_align = Align;
+
+    static void* allocate(StaticPool<BlockSize, N, Align>& pool) noexcept
+    {
+        return pool.allocate();
+    }
+
+    static void deallocate(StaticPool<BlockSize, N, Align>& pool, void* p_block) noexcept
+    {
+        pool.deallocate_unchecked(p_block);
+    }
+
+    static bool owns(const StaticPool<BlockSize, N, Align>& pool, const void* p_block) noexcept
+    {
+        return pool.owns(p_block);
+    }
+};
+
+/**
+ * @brief   Allocator taking single-object requests that fit one block from a pool
+ * @tparam  T       Value type
+ * @tparam  Pool    TPool_handle or a StaticPool<>
+ *
+ * @note    Requests for several objects, objects larger than a block or with a
+ *          stricter alignment, and requests the exhausted pool cannot serve go
+ *          to std::allocator<T>. Allocators compare equal when they share a pool.
+ */
+template <typename T, typename Pool = TPool_handle>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = PoolAllocator<U, Pool>;
+    };
+
+    explicit PoolAllocator(Pool& pool) noexcept : pool_(&pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Pool>& other) noexcept : pool_(other.pool()) {}
+
+    /**
+     * @brief  Allocate storage for n objects
+     * @param  n   Number of objects
+     * @return Pointer to the storage
+     */
+    T* allocate(std::size_t n)
+    {
+        if (fits(n))
+        {
+            void* p_block = pool_traits<Pool>::allocate(*pool_);
+            if (p_block != nullptr) [[likely]]
+            {
+                return static_cast<T*>(p_block);
+            }
+        }
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    /**
+     * @brief  Release storage obtained from allocate()
+     * @param  p   Pointer returned by allocate(n)
+     * @param  n   Number of objects passed to allocate()
+     */
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        if (fits(n) && pool_traits<Pool>::owns(*pool_, p))
+        {
+            pool_traits<Pool>::deallocate(*pool_, p);
+            return;
+        }
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    /**
+     * @brief  Pool the allocator takes blocks from
+     */
+    Pool* pool() const noexcept
+    {
+        return pool_;
+    }
+
+private:
+    /**
+     * @brief  Test whether a request for n objects is a single object fitting one block
+     */
+    static bool fits(std::size_t n) noexcept
+    {
+        return (n == 1U) && (sizeof(T) <= pool_traits<Pool>::block_size) &&
+               (alignof(T) <= pool_traits<Pool>::block_align);
+    }
+
+    Pool* pool_;    /**< Pool serving the requests that fit */
+};
+
+/**
+ * @brief   Allocators are equal when they share a pool
+ */
+template <typename T, typename U, typename Pool>
+bool operator==(const PoolAllocator<T, Pool>& a, const PoolAllocator<U, Pool>& b) noexcept
+{
+    return a.pool() == b.pool();
+}
+
+/**
+ * @brief   Memory resource taking requests that fit one block from a pool
+ * @tparam  Pool    TPool_handle or a StaticPool<>
+ *
+ * @note    Other requests and requests the exhausted pool cannot serve go to the
+ *          upstream resource. Resources are equal only to themselves.
+ */
+template <typename Pool = TPool_handle>
+class basic_pool_memory_resource : public std::pmr::memory_resource
+{
+public:
+    /**
+     * @brief  Create a resource over a pool
+     * @param  pool        Pool serving the requests that fit
+     * @param  p_upstream  Resource serving all other requests
+     */
+    explicit basic_pool_memory_resource(Pool& pool,
+                                        std::pmr::memory_resource* p_upstream = std::pmr::get_default_resource()) noexcept
+        : pool_(&pool), upstream_(p_upstream)
+    {
+    }
+
+    basic_pool_memory_resource(const basic_pool_memory_resource&) = delete;
+    basic_pool_memory_resource& operator=(const basic_pool_memory_resource&) = delete;
+
+    /**
+     * @brief  Pool the resource takes blocks from
+     */
+    Pool* pool() const noexcept
+    {
+        return pool_;
+    }
+
+    /**
+     * @brief  Resource serving the requests that do not fit the pool
+     */
+    std::pmr::memory_resource* upstream_resource() const noexcept
+    {
+        return upstream_;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (fits(bytes, alignment))
+        {
+            void* p_block = pool_traits<Pool>::allocate(*pool_);
+            if (p_block != nullptr) [[likely]]
+            {
+                return p_block;
+            }
+        }
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        if (fits(bytes, alignment) && pool_traits<Pool>::owns(*pool_, p))
+        {
+            pool_traits<Pool>::deallocate(*pool_, p);
+            return;
+        }
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    /**
+     * @brief  Test whether a request fits one block
+     */
+    static bool fits(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        return (bytes <= pool_traits<Pool>::block_size) && (alignment <= pool_traits<Pool>::block_align);
+    }
+
+    Pool* pool_;                            /**< Pool serving the requests that fit */
+    std::pmr::memory_resource* upstream_;   /**< Resource serving all other requests */
+};
+
+/**
+ * @brief   Memory resource over the C pool configured in pool_cfg.h
+ */
+using pool_memory_resource = basic_pool_memory_resource<TPool_handle>;
+
+#endif /* POOL_ALLOCATOR_HPP */
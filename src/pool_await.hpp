@@ -0,0 +1,206 @@
+/**
+ * @file        pool_await.hpp
+ * @brief       Awaitable block acquisition that suspends until a block is freed
+ * @details     AwaitablePool<Pool> puts a wait queue in front of a pool. When the
+ *              pool is exhausted, `co_await pool.acquire()` suspends the calling
+ *              coroutine in an intrusive FIFO queue. release() hands a freed block
+ *              directly to the oldest waiter instead of returning it to the pool, and
+ *              resumes that waiter through the executor it passed to acquire().
+ *
+ *              The queue nodes live in the awaiting coroutine frames, so waiting
+ *              allocates nothing. A block is never put back into the pool while
+ *              somebody waits for one, so no wakeup can be lost and a new caller
+ *              cannot overtake a waiter.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_AWAIT_HPP
+#define POOL_AWAIT_HPP
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include "pool.h"
+#include "pool_allocator.hpp"
+
+/**
+ * @brief   Executor a waiter is resumed on
+ * @details post() must arrange for the handle to be resumed, either at once or
+ *          later from the event loop of the executor.
+ */
+template <typename Executor>
+concept pool_executor = requires(Executor& executor, std::coroutine_handle<> handle) {
+    { executor.post(handle) } -> std::same_as<void>;
+};
+
+/**
+ * @brief   Executor resuming the waiter inline, inside release()
+ */
+struct pool_inline_executor
+{
+    void post(std::coroutine_handle<> handle) const
+    {
+        handle.resume();
+    }
+};
+
+/**
+ * @brief   Pool with a FIFO queue of coroutines waiting for a block
+ * @tparam  Pool    TPool_handle or a StaticPool<>
+ *
+ * @note    Blocks acquired through the wait queue must be freed with release(),
+ *          otherwise waiters are not woken. A coroutine must not be destroyed while
+ *          it waits in the queue.
+ */
+template <typename Pool = TPool_handle>
+class AwaitablePool
+{
+    using traits = pool_traits<Pool>;
+
+    /**
+     * @brief Intrusive queue node, part of the awaiter in the waiting coroutine frame
+     */
+    struct waiter
+    {
+        waiter*                 next;                   /**< Next younger waiter */
+        void*                   block;                  /**< Block handed over by release() */
+        std::coroutine_handle<> handle;                 /**< Suspended coroutine */
+        void                    (*wake)(waiter& self);  /**< Posts handle to the executor of the waiter */
+    };
+
+public:
+    /**
+     * @brief   Awaiter returned by acquire()
+     * @details Completes without suspending when nobody waits and the pool has a
+     *          free block; co_await yields the block.
+     */
+    template <pool_executor Executor>
+    class acquire_awaiter : private waiter
+    {
+    public:
+        acquire_awaiter(AwaitablePool& owner, Executor& executor) noexcept
+            : waiter{nullptr, nullptr, {}, &wake_on_executor}, owner_(&owner), executor_(&executor) {}
+
+        bool await_ready() noexcept
+        {
+            if (owner_->head_ == nullptr)
+            {
+                this->block = traits::allocate(*owner_->pool_);
+            }
+            return this->block != nullptr;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            this->handle = handle;
+            owner_->enqueue(*this);
+        }
+
+        void* await_resume() const noexcept
+        {
+            return this->block;
+        }
+
+    private:
+        static void wake_on_executor(waiter& self)
+        {
+            acquire_awaiter& awaiter = static_cast<acquire_awaiter&>(self);
+            awaiter.executor_->post(awaiter.handle);
+        }
+
+        AwaitablePool* owner_;
+        Executor*      executor_;
+    };
+
+    explicit AwaitablePool(Pool& pool) noexcept : pool_(&pool) {}
+
+    AwaitablePool(const AwaitablePool&) = delete;
+    AwaitablePool& operator=(const AwaitablePool&) = delete;
+
+    /**
+     * @brief  Acquire a block, suspending while the pool is exhausted
+     * @param  executor    Executor the caller is resumed on after a suspension
+     * @return Awaiter yielding the block (void*)
+     */
+    template <pool_executor Executor>
+    acquire_awaiter<Executor> acquire(Executor& executor) noexcept
+    {
+        return acquire_awaiter<Executor>(*this, executor);
+    }
+
+    /**
+     * @brief  Acquire a block, resuming inline in release() after a suspension
+     * @return Awaiter yielding the block (void*)
+     */
+    acquire_awaiter<const pool_inline_executor> acquire() noexcept
+    {
+        static constexpr pool_inline_executor inline_executor{};
+        return acquire_awaiter<const pool_inline_executor>(*this, inline_executor);
+    }
+
+    /**
+     * @brief  Free a block, handing it to the oldest waiter if there is one
+     * @param  p_block Block acquired from this pool
+     * @note   The waiter is dequeued before it is posted, so an inline resume may
+     *         call acquire() and release() again
+     */
+    void release(void* p_block)
+    {
+        waiter* oldest = head_;
+
+        if (oldest == nullptr)
+        {
+            traits::deallocate(*pool_, p_block);
+            return;
+        }
+
+        head_ = oldest->next;
+        tail_ = (head_ == nullptr) ? nullptr : tail_;
+        waiting_--;
+        oldest->block = p_block;
+        oldest->wake(*oldest);
+    }
+
+    /**
+     * @brief  Get the number of suspended waiters
+     * @return Number of coroutines in the wait queue
+     */
+    std::size_t waiting() const noexcept
+    {
+        return waiting_;
+    }
+
+    /**
+     * @brief  Get the underlying pool
+     * @return Reference to the pool
+     */
+    Pool& pool() const noexcept
+    {
+        return *pool_;
+    }
+
+private:
+    void enqueue(waiter& node) noexcept
+    {
+        node.next = nullptr;
+        if (tail_ == nullptr)
+        {
+            head_ = &node;
+        }
+        else
+        {
+            tail_->next = &node;
+        }
+        tail_ = &node;
+        waiting_++;
+    }
+
+    Pool*       pool_;
+    waiter*     head_ = nullptr;    /**< Oldest waiter, served first */
+    waiter*     tail_ = nullptr;    /**< Youngest waiter */
+    std::size_t waiting_ = 0U;      /**< Number of queued waiters */
+};
+
+#endif /* POOL_AWAIT_HPP */
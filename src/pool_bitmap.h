@@ -0,0 +1,161 @@
+/**
+ * @file        pool_bitmap.h
+ * @brief       Allocation bitmap primitives
+ * @details     Word based helpers for the allocation bitmap (1 = allocated, 0 = free).
+ *              They are defined inline so that the allocation fast path in pool.h
+ *              compiles down to a few instructions. These helpers are internal to the
+ *              pool implementation and should not be used by applications.
+ *              Block and word indices are uintptr: a bitmap never covers more blocks
+ *              than there are addressable bytes, and the helpers also serve pools
+ *              whose size is only known at run time.
+ */
+
+#ifndef POOL_BITMAP_H
+#define POOL_BITMAP_H
+
+#include "pool_types.h"
+#include "compiler_abstraction.h"
+
+/**
+ * @brief Index of the lowest set bit of a non-zero word
+ * @param word Bitmap word, must not be 0
+ * @return uint32 Bit position (0-based) of the lowest set bit
+ */
+LOCAL_INLINE uint32 pool_word_ctz(TPool_word word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    if (sizeof(TPool_word) > sizeof(unsigned int))
+    {
+        return (uint32)__builtin_ctzll((unsigned long long)word);
+    }
+    return (uint32)__builtin_ctz((unsigned int)word);
+#else
+    uint32 bit = 0U;
+    while (0U == (word & 1U))
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * @brief Number of set bits in a word
+ * @param word Bitmap word
+ * @return uint32 Number of bits set to 1
+ */
+LOCAL_INLINE uint32 pool_word_popcount(TPool_word word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32)__builtin_popcountll((unsigned long long)word);
+#else
+    uint32 count = 0U;
+    while (0U != word)
+    {
+        word &= word - 1U;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Set the bit of a block in the bitmap
+ * @param bitmap Pointer to the bitmap words
+ * @param index  Block index (0-based), no bounds checking is performed
+ */
+LOCAL_INLINE void pool_bit_set(TPool_word* bitmap, uintptr index)
+{
+    bitmap[index / POOL_WORD_BITS] |= (TPool_word)1U << (index % POOL_WORD_BITS);
+}
+
+/**
+ * @brief Clear the bit of a block in the bitmap
+ * @param bitmap Pointer to the bitmap words
+ * @param index  Block index (0-based), no bounds checking is performed
+ */
+LOCAL_INLINE void pool_bit_clear(TPool_word* bitmap, uintptr index)
+{
+    bitmap[index / POOL_WORD_BITS] &= ~((TPool_word)1U << (index % POOL_WORD_BITS));
+}
+
+/**
+ * @brief Test the bit of a block in the bitmap
+ * @param bitmap Pointer to the bitmap words
+ * @param index  Block index (0-based), no bounds checking is performed
+ * @return uint8 1 if the block is allocated, 0 if it is free
+ */
+LOCAL_INLINE uint8 pool_bit_test(const TPool_word* bitmap, uintptr index)
+{
+    return (uint8)((bitmap[index / POOL_WORD_BITS] >> (index % POOL_WORD_BITS)) & 1U);
+}
+
+/**
+ * @brief Find the first bitmap word that still has a free block
+ * @param bitmap     Pointer to the bitmap words
+ * @param num_blocks Number of valid blocks covered by the bitmap
+ * @param from_word  Word index to start the search at
+ * @return uintptr Index of the first free block at or after from_word,
+ *         or num_blocks if every block is allocated
+ *
+ * @note  Bits beyond num_blocks in the last word are ignored.
+ */
+LOCAL_INLINE uintptr pool_bitmap_find_free(const TPool_word* bitmap, uintptr num_blocks, uintptr from_word)
+{
+    uintptr num_words = (num_blocks + (POOL_WORD_BITS - 1U)) / POOL_WORD_BITS;
+    uintptr i;
+
+    for (i = from_word; i < num_words; i++)
+    {
+        TPool_word free_bits = (TPool_word)~bitmap[i];
+        if (0U != free_bits)
+        {
+            uintptr index = (i * POOL_WORD_BITS) + pool_word_ctz(free_bits);
+            return (index < num_blocks) ? index : num_blocks;
+        }
+    }
+
+    return num_blocks;
+}
+
+/**
+ * @brief Find the next block at or after a given index with the given state
+ * @param bitmap     Pointer to the bitmap words
+ * @param num_blocks Number of valid blocks covered by the bitmap
+ * @param from       Block index to start the search at
+ * @param allocated  1 to find the next allocated block, 0 to find the next free one
+ * @return uintptr Index of the block found, or num_blocks if there is none
+ *
+ * @note  Whole words that cannot match are skipped with one compare, so walking
+ *        the runs of a sparse bitmap is proportional to the number of words.
+ */
+LOCAL_INLINE uintptr pool_bitmap_next(const TPool_word* bitmap, uintptr num_blocks, uintptr from, uint8 allocated)
+{
+    TPool_word invert = (0U != allocated) ? (TPool_word)0U : (TPool_word)~(TPool_word)0U;
+    uintptr word_index = from / POOL_WORD_BITS;
+    TPool_word match;
+
+    if (from >= num_blocks)
+    {
+        return num_blocks;
+    }
+
+    /* Drop the bits below from in the first word */
+    match = (bitmap[word_index] ^ invert) & ((TPool_word)~(TPool_word)0U << (from % POOL_WORD_BITS));
+
+    while (0U == match)
+    {
+        word_index++;
+        if ((word_index * POOL_WORD_BITS) >= num_blocks)
+        {
+            return num_blocks;
+        }
+        match = bitmap[word_index] ^ invert;
+    }
+
+    from = (word_index * POOL_WORD_BITS) + pool_word_ctz(match);
+    return (from < num_blocks) ? from : num_blocks;
+}
+
+#endif /* POOL_BITMAP_H */
@@ -0,0 +1,243 @@
+/**
+ * @file        pool_cache.c
+ * @brief       Object cache with preserved constructed state
+ * @details     Free objects are tracked in a bitmap of the cache rather than in a
+ *              list threaded through the blocks, so the cache never writes into an
+ *              object and the constructed state survives untouched.
+ */
+
+#include "pool_cache.h"
+#include "pool.h"
+
+/**
+ * @brief Block index of an object, or POOL_NUM_BLOCKS if it is not a block of the pool
+ */
+static uintptr block_index(const TPool_cache* p_cache, const void* p_object)
+{
+    const uint8* memory = p_cache->pool->memory;
+    uintptr offset = (uintptr)((const uint8*)p_object - memory);
+
+    if (((const uint8*)p_object < memory) || (offset >= sizeof(p_cache->pool->memory)) ||
+        (0U != (offset % POOL_BLOCK_SIZE)))
+    {
+        return POOL_NUM_BLOCKS;
+    }
+
+    return offset / POOL_BLOCK_SIZE;
+}
+
+/**
+ * @brief Destroy one cached object and give its block back to the pool
+ */
+static void release(TPool_cache* p_cache, uintptr index)
+{
+    void* p_object = &p_cache->pool->memory[index * POOL_BLOCK_SIZE];
+
+    pool_bit_clear(p_cache->cached, index);
+    p_cache->cached_count--;
+
+    if (NULL_PTR != p_cache->dtor)
+    {
+        p_cache->dtor(p_object, p_cache->arg);
+    }
+    pool_free(p_cache->pool, p_object);
+}
+
+/**
+ * @brief Initialize an object cache
+ * 
+ * @param p_cache Pointer to the cache handle
+ * @param p_pool  Pointer to the initialized pool the blocks come from
+ * @param ctor    Constructor, NULL if none
+ * @param dtor    Destructor, NULL if none
+ * @param p_arg   Argument passed to ctor and dtor
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK on invalid parameters
+ */
+Std_ReturnType pool_cache_init(TPool_cache* p_cache, TPool_handle* p_pool,
+                               TPool_cache_ctor ctor, TPool_cache_dtor dtor, void* p_arg)
+{
+    uintptr i;
+
+    if ((NULL_PTR == p_cache) || (NULL_PTR == p_pool))
+    {
+        return STD_NOT_OK;
+    }
+
+    p_cache->pool = p_pool;
+    p_cache->ctor = ctor;
+    p_cache->dtor = dtor;
+    p_cache->arg = p_arg;
+    for (i = 0U; i < POOL_BITMAP_WORDS; i++)
+    {
+        p_cache->cached[i] = 0U;
+    }
+    p_cache->hint = 0U;
+    p_cache->cached_count = 0U;
+    p_cache->live_count = 0U;
+
+    return STD_OK;
+}
+
+/**
+ * @brief Allocate a constructed object
+ * 
+ * @param p_cache Pointer to the cache handle
+ * @return void*  Pointer to the object, or NULL if allocation fails
+ * 
+ * @note  - A cached object is handed out without running any callback
+ *        - Only a miss takes a block from the pool and runs the constructor;
+ *          a block whose constructor fails goes straight back to the pool
+ */
+void* pool_cache_alloc(TPool_cache* p_cache)
+{
+    void* p_object;
+    uintptr index;
+
+    if ((NULL_PTR == p_cache) || (NULL_PTR == p_cache->pool))
+    {
+        return NULL_PTR;
+    }
+
+    /* Hit: hand out a constructed object as it is */
+    if (0U != p_cache->cached_count)
+    {
+        index = pool_bitmap_next(p_cache->cached, POOL_NUM_BLOCKS, (uintptr)p_cache->hint * POOL_WORD_BITS, 1U);
+        pool_bit_clear(p_cache->cached, index);
+        p_cache->hint = (TPool_index)(index / POOL_WORD_BITS);
+        p_cache->cached_count--;
+        p_cache->live_count++;
+        return &p_cache->pool->memory[index * POOL_BLOCK_SIZE];
+    }
+
+    /* Miss: a new block enters the cache and is constructed once */
+    p_object = pool_alloc(p_cache->pool);
+    if (NULL_PTR == p_object)
+    {
+        return NULL_PTR;
+    }
+    if ((NULL_PTR != p_cache->ctor) && (STD_OK != p_cache->ctor(p_object, p_cache->arg)))
+    {
+        pool_free(p_cache->pool, p_object);
+        return NULL_PTR;
+    }
+
+    p_cache->live_count++;
+    return p_object;
+}
+
+/**
+ * @brief Return an object to the cache
+ * 
+ * @param p_cache  Pointer to the cache handle
+ * @param p_object Pointer to an object returned by pool_cache_alloc()
+ * 
+ * @note  - The object keeps its block and its constructed state
+ *        - Rejects pointers outside the pool, misaligned pointers, blocks that
+ *          are free in the pool and objects already in the cache
+ */
+void pool_cache_free(TPool_cache* p_cache, void* p_object)
+{
+    uintptr index;
+
+    if ((NULL_PTR == p_cache) || (NULL_PTR == p_cache->pool) || (NULL_PTR == p_object))
+    {
+        return;
+    }
+
+    index = block_index(p_cache, p_object);
+    if ((index >= POOL_NUM_BLOCKS) || (0U == pool_bit_test(p_cache->pool->bitmap, index)) ||
+        (0U != pool_bit_test(p_cache->cached, index)))
+    {
+        return;
+    }
+
+    pool_bit_set(p_cache->cached, index);
+    p_cache->hint = ((index / POOL_WORD_BITS) < p_cache->hint) ? (TPool_index)(index / POOL_WORD_BITS) : p_cache->hint;
+    p_cache->cached_count++;
+    p_cache->live_count--;
+}
+
+/**
+ * @brief Destroy cached objects and give their blocks back to the pool
+ * 
+ * @param p_cache Pointer to the cache handle
+ * @param keep    Number of cached objects to keep constructed
+ * @return TPool_index Number of blocks given back to the pool
+ */
+TPool_index pool_cache_reap(TPool_cache* p_cache, TPool_index keep)
+{
+    TPool_index released = 0U;
+    TPool_index kept = 0U;
+    uintptr index;
+
+    if ((NULL_PTR == p_cache) || (NULL_PTR == p_cache->pool))
+    {
+        return 0U;
+    }
+
+    index = pool_bitmap_next(p_cache->cached, POOL_NUM_BLOCKS, (uintptr)p_cache->hint * POOL_WORD_BITS, 1U);
+    while ((index < POOL_NUM_BLOCKS) && (p_cache->cached_count > keep))
+    {
+        if (kept < keep)
+        {
+            kept++;
+        }
+        else
+        {
+            release(p_cache, index);
+            released++;
+        }
+        index = pool_bitmap_next(p_cache->cached, POOL_NUM_BLOCKS, index + 1U, 1U);
+    }
+
+    return released;
+}
+
+/**
+ * @brief Get the number of constructed objects waiting in the cache
+ * 
+ * @param p_cache Pointer to the cache handle
+ * @return TPool_index Number of cached objects, 0 if p_cache is NULL
+ */
+TPool_index pool_cache_get_cached_count(const TPool_cache* p_cache)
+{
+    return (NULL_PTR != p_cache) ? p_cache->cached_count : 0U;
+}
+
+/**
+ * @brief Destroy every cached object and detach the cache from its pool
+ * 
+ * @param p_cache Pointer to the cache handle
+ */
+void pool_cache_deinit(TPool_cache* p_cache)
+{
+    if (NULL_PTR == p_cache)
+    {
+        return;
+    }
+
+    (void)pool_cache_reap(p_cache, 0U);
+    p_cache->pool = NULL_PTR;
+}
+
+#if (POOL_RECLAIM == STD_ON)
+/**
+ * @brief Reclaim hook giving cached objects of a cache back to its pool
+ * 
+ * @param p_handle   Exhausted pool
+ * @param max_blocks Number of blocks to give back at most
+ * @param p_cache    Pointer to the TPool_cache built on p_handle
+ * @return TPool_index Number of blocks given back
+ */
+TPool_index pool_cache_reclaim(TPool_handle* p_handle, TPool_index max_blocks, void* p_cache)
+{
+    TPool_cache* cache = (TPool_cache*)p_cache;
+
+    if ((NULL_PTR == cache) || (cache->pool != p_handle))
+    {
+        return 0U;
+    }
+
+    return pool_cache_reap(cache, (cache->cached_count > max_blocks) ? (TPool_index)(cache->cached_count - max_blocks) : 0U);
+}
+#endif
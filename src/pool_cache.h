@@ -0,0 +1,126 @@
+/**
+ * @file        pool_cache.h
+ * @brief       Object cache with preserved constructed state
+ * @details     A cache keeps objects constructed between uses, as in Bonwick's slab
+ *              allocator. The constructor runs once when a block of the pool enters
+ *              the cache and the destructor once when the block leaves it again, so
+ *              pool_cache_alloc() and pool_cache_free() only hand out and take back
+ *              objects that are already initialized.
+ *
+ *              Cached objects stay allocated in the underlying pool. A block therefore
+ *              keeps holding an object of the cache type until pool_cache_reap() gives
+ *              it back: readers that look at an object after it was freed see a valid
+ *              (possibly reused) object of the same type, never foreign data.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_CACHE_H
+#define POOL_CACHE_H
+
+#include "pool_types.h"
+
+/**
+ * @brief   Constructor run when a block enters the cache
+ * @param   p_object    Pointer to the block, POOL_BLOCK_SIZE bytes
+ * @param   p_arg       Argument passed to pool_cache_init()
+ * @return  STD_OK if the object is constructed, STD_NOT_OK to fail the allocation
+ */
+typedef Std_ReturnType (*TPool_cache_ctor)(void* p_object, void* p_arg);
+
+/**
+ * @brief   Destructor run when a block leaves the cache
+ * @param   p_object    Pointer to a constructed object
+ * @param   p_arg       Argument passed to pool_cache_init()
+ */
+typedef void (*TPool_cache_dtor)(void* p_object, void* p_arg);
+
+/**
+ * @brief   Object cache handle
+ */
+typedef struct pool_cache {
+    TPool_handle*    pool;                       /**< Pool the blocks come from */
+    TPool_cache_ctor ctor;                       /**< Constructor, NULL if none */
+    TPool_cache_dtor dtor;                       /**< Destructor, NULL if none */
+    void*            arg;                        /**< Argument of ctor and dtor */
+    TPool_word       cached[POOL_BITMAP_WORDS];  /**< Constructed objects that are free in the cache (1 = cached) */
+    TPool_index      hint;                       /**< Lowest word of cached that may have a bit set */
+    TPool_index      cached_count;               /**< Number of constructed free objects */
+    TPool_index      live_count;                 /**< Number of objects held by the application */
+} TPool_cache;
+
+/**
+ * @brief   Initialize an object cache
+ * @param   p_cache     Pointer to the cache handle
+ * @param   p_pool      Pointer to the initialized pool the blocks come from
+ * @param   ctor        Constructor, NULL if blocks need no construction
+ * @param   dtor        Destructor, NULL if objects need no destruction
+ * @param   p_arg       Argument passed to ctor and dtor
+ * @return  STD_OK on success, STD_NOT_OK if p_cache or p_pool is NULL
+ * @note    The pool may be shared with other users; the cache only takes blocks
+ *          through pool_alloc() and returns them through pool_free()
+ */
+Std_ReturnType pool_cache_init(TPool_cache* p_cache, TPool_handle* p_pool,
+                               TPool_cache_ctor ctor, TPool_cache_dtor dtor, void* p_arg);
+
+/**
+ * @brief   Allocate a constructed object
+ * @param   p_cache     Pointer to the cache handle
+ * @return  Pointer to the object, or NULL if the pool is exhausted or the constructor fails
+ * @note    Takes the lowest cached object; the constructor only runs when the cache
+ *          is empty and a new block is taken from the pool
+ */
+void* pool_cache_alloc(TPool_cache* p_cache);
+
+/**
+ * @brief   Return an object to the cache
+ * @param   p_cache     Pointer to the cache handle
+ * @param   p_object    Pointer to an object returned by pool_cache_alloc()
+ * @return  None
+ * @pre     The object must be back in its constructed state
+ * @note    The destructor does not run. Pointers outside the pool, misaligned
+ *          pointers and objects already in the cache are ignored.
+ */
+void pool_cache_free(TPool_cache* p_cache, void* p_object);
+
+/**
+ * @brief   Destroy cached objects and give their blocks back to the pool
+ * @param   p_cache     Pointer to the cache handle
+ * @param   keep        Number of cached objects to keep constructed
+ * @return  Number of blocks given back to the pool
+ * @note    The lowest blocks are kept, they are the ones pool_cache_alloc() hands
+ *          out next. Lock-free readers must have stopped looking at the released
+ *          objects before this is called.
+ */
+TPool_index pool_cache_reap(TPool_cache* p_cache, TPool_index keep);
+
+/**
+ * @brief   Get the number of constructed objects waiting in the cache
+ * @param   p_cache     Pointer to the cache handle
+ * @return  Number of cached objects, 0 if p_cache is NULL
+ */
+TPool_index pool_cache_get_cached_count(const TPool_cache* p_cache);
+
+/**
+ * @brief   Destroy every cached object and detach the cache from its pool
+ * @param   p_cache     Pointer to the cache handle
+ * @return  None
+ * @pre     The application holds no objects of the cache
+ */
+void pool_cache_deinit(TPool_cache* p_cache);
+
+#if (POOL_RECLAIM == STD_ON)
+/**
+ * @brief   Reclaim hook giving cached objects of a cache back to its pool
+ * @param   p_handle    Exhausted pool
+ * @param   max_blocks  Number of blocks to give back at most
+ * @param   p_cache     Pointer to the TPool_cache built on p_handle
+ * @return  Number of blocks given back
+ * @note    Register with pool_reclaim_register(&pool, pool_cache_reclaim, &cache).
+ *          Only cached objects are destroyed; objects held by the application stay.
+ */
+TPool_index pool_cache_reclaim(TPool_handle* p_handle, TPool_index max_blocks, void* p_cache);
+#endif
+
+#endif /* POOL_CACHE_H */
@@ -0,0 +1,351 @@
+/**
+ * @file        pool_chain.c
+ * @brief       Pool chain with lazily created overflow chunks
+ * @details     Chunks are kept sorted by address so that pool_chain_free() finds the
+ *              owner of a block with one range check for the primary pool and a
+ *              binary search over at most POOL_CHAIN_MAX_CHUNKS chunks.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "pool_chain.h"
+#include "pool.h"
+#include "pool_os.h"
+#include "helper_routines.h"
+
+/**
+ * @brief Size of the mapping holding one chunk from POOL_CHAIN_SOURCE_MMAP
+ */
+static uintptr mapping_size(void)
+{
+    uintptr page_size = pool_os_page_size();
+    return (sizeof(TPool_handle) + (page_size - 1U)) & ~(page_size - 1U);
+}
+
+/**
+ * @brief Test whether a block lies in the memory area of a pool
+ */
+static boolean owns(const TPool_handle* pool, const void* p_block)
+{
+    return (boolean)(((const uint8*)p_block >= pool->memory) &&
+                     ((const uint8*)p_block < (pool->memory + sizeof(pool->memory))));
+}
+
+/**
+ * @brief Zero the handle state that follows the memory area of a heap chunk
+ * @details aligned_alloc() returns garbage and POOL_INIT_METADATA only resets the
+ *          bitmap and the counters, while the trim threshold and the state of
+ *          POOL_SCRUB, POOL_WAIT, POOL_WATERMARKS and POOL_RECLAIM behind them are
+ *          kept. Everything from the bitmap to the end of the handle must start out
+ *          zero; the memory area itself may stay garbage.
+ */
+static void clear_state(TPool_handle* chunk)
+{
+    (void)mem_set(chunk->bitmap, 0, sizeof(TPool_handle) - offsetof(TPool_handle, bitmap));
+}
+
+/**
+ * @brief Take a new chunk from the configured source
+ * @param p_chain Pointer to the chain handle
+ * @return TPool_handle* Initialized chunk, or NULL if the source is exhausted
+ */
+static TPool_handle* chunk_create(TPool_chain* p_chain)
+{
+    TPool_handle* chunk = NULL_PTR;
+    uint32 i;
+
+    switch (p_chain->source)
+    {
+        case POOL_CHAIN_SOURCE_STATIC:
+            for (i = 0U; i < p_chain->reserve_count; i++)
+            {
+                if (FALSE == p_chain->reserve_taken[i])
+                {
+                    p_chain->reserve_taken[i] = TRUE;
+                    chunk = &p_chain->reserve[i];
+                    pool_init_ex(chunk, POOL_INIT_METADATA);
+                    break;
+                }
+            }
+            break;
+
+        case POOL_CHAIN_SOURCE_MMAP:
+            chunk = (TPool_handle*)pool_os_map(mapping_size());
+            if (NULL_PTR != chunk)
+            {
+                pool_init_ex(chunk, POOL_INIT_ZEROED);  /* Fresh mapping reads as zero */
+            }
+            break;
+
+        case POOL_CHAIN_SOURCE_MALLOC:
+        default:
+            chunk = (TPool_handle*)aligned_alloc(_Alignof(TPool_handle), sizeof(TPool_handle));
+            if (NULL_PTR != chunk)
+            {
+                clear_state(chunk);
+                pool_init_ex(chunk, POOL_INIT_METADATA);
+            }
+            break;
+    }
+
+    return chunk;
+}
+
+/**
+ * @brief Give a chunk back to the configured source
+ */
+static void chunk_destroy(TPool_chain* p_chain, TPool_handle* chunk)
+{
+    switch (p_chain->source)
+    {
+        case POOL_CHAIN_SOURCE_STATIC:
+            p_chain->reserve_taken[chunk - p_chain->reserve] = FALSE;
+            break;
+
+        case POOL_CHAIN_SOURCE_MMAP:
+            pool_os_unmap(chunk, mapping_size());
+            break;
+
+        case POOL_CHAIN_SOURCE_MALLOC:
+        default:
+            free(chunk);
+            break;
+    }
+}
+
+/**
+ * @brief Index of the chunk owning a block
+ * @return uint32 Chunk index, or num_chunks if no chunk owns the block
+ */
+static uint32 find_chunk(const TPool_chain* p_chain, const void* p_block)
+{
+    uint32 low = 0U;
+    uint32 high = p_chain->num_chunks;
+
+    /* Last chunk starting at or below the block */
+    while (low < high)
+    {
+        uint32 mid = (low + high) / 2U;
+        if ((const uint8*)p_block < p_chain->chunks[mid]->memory)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1U;
+        }
+    }
+
+    if ((low > 0U) && (TRUE == owns(p_chain->chunks[low - 1U], p_block)))
+    {
+        return low - 1U;
+    }
+    return p_chain->num_chunks;
+}
+
+/**
+ * @brief Remove chunk i from the sorted chunk list and release it
+ */
+static void remove_chunk(TPool_chain* p_chain, uint32 index)
+{
+    TPool_handle* chunk = p_chain->chunks[index];
+    uint32 i;
+
+    for (i = index + 1U; i < p_chain->num_chunks; i++)
+    {
+        p_chain->chunks[i - 1U] = p_chain->chunks[i];
+        p_chain->empty_since[i - 1U] = p_chain->empty_since[i];
+    }
+    p_chain->num_chunks--;
+
+    chunk_destroy(p_chain, chunk);
+}
+
+/**
+ * @brief Initialize a pool chain
+ * 
+ * @param p_chain       Pointer to the chain handle
+ * @param p_primary     Pointer to the initialized primary pool
+ * @param source        Source of overflow chunks
+ * @param p_reserve     Array of handles for POOL_CHAIN_SOURCE_STATIC
+ * @param reserve_count Number of handles in p_reserve
+ * @param cooldown_ns   Time an overflow chunk stays empty before it is released
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK on invalid parameters
+ */
+Std_ReturnType pool_chain_init(TPool_chain* p_chain, TPool_handle* p_primary, TPool_chain_source source,
+                               TPool_handle* p_reserve, uint32 reserve_count, uint64 cooldown_ns)
+{
+    uint32 i;
+
+    if ((NULL_PTR == p_chain) || (NULL_PTR == p_primary) ||
+        ((POOL_CHAIN_SOURCE_STATIC == source) && (NULL_PTR == p_reserve)))
+    {
+        return STD_NOT_OK;
+    }
+
+    p_chain->primary = p_primary;
+    p_chain->num_chunks = 0U;
+    p_chain->source = source;
+    p_chain->reserve = p_reserve;
+    p_chain->reserve_count = (reserve_count < POOL_CHAIN_MAX_CHUNKS) ? reserve_count : POOL_CHAIN_MAX_CHUNKS;
+    p_chain->cooldown_ns = cooldown_ns;
+    for (i = 0U; i < POOL_CHAIN_MAX_CHUNKS; i++)
+    {
+        p_chain->reserve_taken[i] = FALSE;
+    }
+
+    return STD_OK;
+}
+
+/**
+ * @brief Allocate a block from the chain
+ * 
+ * @param p_chain Pointer to the chain handle
+ * @return void*  Pointer to the allocated block, or NULL if allocation fails
+ * 
+ * @note  - The primary pool is tried first, then the chunks in address order
+ *        - A new chunk is added only when every existing one is exhausted
+ *        - Returns NULL if p_chain is NULL, POOL_CHAIN_MAX_CHUNKS chunks exist or
+ *          the source cannot provide another chunk
+ */
+void* pool_chain_alloc(TPool_chain* p_chain)
+{
+    TPool_handle* chunk;
+    void* block;
+    uint32 i;
+
+    if (NULL_PTR == p_chain)
+    {
+        return NULL_PTR;
+    }
+
+    block = pool_alloc_fast(p_chain->primary);
+    if (LIKELY(NULL_PTR != block))
+    {
+        return block;
+    }
+
+    for (i = 0U; i < p_chain->num_chunks; i++)
+    {
+        block = pool_alloc_fast(p_chain->chunks[i]);
+        if (NULL_PTR != block)
+        {
+            p_chain->empty_since[i] = POOL_CHAIN_IN_USE;
+            return block;
+        }
+    }
+
+    /* Every pool is exhausted: add a chunk, keeping the list sorted */
+    if (p_chain->num_chunks >= POOL_CHAIN_MAX_CHUNKS)
+    {
+        return NULL_PTR;
+    }
+
+    chunk = chunk_create(p_chain);
+    if (NULL_PTR == chunk)
+    {
+        return NULL_PTR;
+    }
+
+    for (i = p_chain->num_chunks; (i > 0U) && (p_chain->chunks[i - 1U]->memory > chunk->memory); i--)
+    {
+        p_chain->chunks[i] = p_chain->chunks[i - 1U];
+        p_chain->empty_since[i] = p_chain->empty_since[i - 1U];
+    }
+    p_chain->chunks[i] = chunk;
+    p_chain->empty_since[i] = POOL_CHAIN_IN_USE;
+    p_chain->num_chunks++;
+
+    return pool_alloc_fast(chunk);
+}
+
+/**
+ * @brief Free a block to the pool of the chain that owns it
+ * 
+ * @param p_chain Pointer to the chain handle
+ * @param p_block Pointer to the block to free
+ * 
+ * @note  - When a chunk becomes empty its cooldown starts and chunks whose
+ *          cooldown has expired are released
+ */
+void pool_chain_free(TPool_chain* p_chain, void* p_block)
+{
+    uint32 index;
+
+    if ((NULL_PTR == p_chain) || (NULL_PTR == p_block))
+    {
+        return;
+    }
+
+    if (LIKELY(TRUE == owns(p_chain->primary, p_block)))
+    {
+        pool_free(p_chain->primary, p_block);
+        return;
+    }
+
+    index = find_chunk(p_chain, p_block);
+    if (index >= p_chain->num_chunks)
+    {
+        return;  /* Invalid pointer - not from this chain */
+    }
+
+    pool_free(p_chain->chunks[index], p_block);
+    if (POOL_NUM_BLOCKS == pool_get_free_count(p_chain->chunks[index]))
+    {
+        p_chain->empty_since[index] = pool_os_now_ns();
+        (void)pool_chain_release_idle(p_chain);
+    }
+}
+
+/**
+ * @brief Release every overflow chunk whose cooldown has expired
+ * 
+ * @param p_chain Pointer to the chain handle
+ * @return uint32 Number of chunks released
+ */
+uint32 pool_chain_release_idle(TPool_chain* p_chain)
+{
+    uint64 now;
+    uint32 released = 0U;
+    uint32 i = 0U;
+
+    if (NULL_PTR == p_chain)
+    {
+        return 0U;
+    }
+
+    now = pool_os_now_ns();
+    while (i < p_chain->num_chunks)
+    {
+        if ((POOL_CHAIN_IN_USE != p_chain->empty_since[i]) &&
+            ((now - p_chain->empty_since[i]) >= p_chain->cooldown_ns))
+        {
+            remove_chunk(p_chain, i);
+            released++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return released;
+}
+
+/**
+ * @brief Release every overflow chunk of the chain
+ * 
+ * @param p_chain Pointer to the chain handle
+ */
+void pool_chain_deinit(TPool_chain* p_chain)
+{
+    if (NULL_PTR == p_chain)
+    {
+        return;
+    }
+
+    while (p_chain->num_chunks > 0U)
+    {
+        remove_chunk(p_chain, p_chain->num_chunks - 1U);
+    }
+}
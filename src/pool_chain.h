@@ -0,0 +1,93 @@
+/**
+ * @file        pool_chain.h
+ * @brief       Pool chain with lazily created overflow chunks
+ * @details     A chain puts overflow chunks behind a primary pool. When the primary
+ *              pool and every chunk are exhausted, a new chunk (a TPool_handle) is
+ *              taken from the configured source instead of failing the allocation.
+ *              Chunks that stay empty for the cooldown period are given back.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_CHAIN_H
+#define POOL_CHAIN_H
+
+#include "pool_types.h"
+
+/**
+ * @brief   Value of empty_since for a chunk that holds blocks
+ */
+#define POOL_CHAIN_IN_USE   (~0ULL)
+
+/**
+ * @brief   Where overflow chunks come from
+ */
+typedef enum {
+    POOL_CHAIN_SOURCE_STATIC = 0,   /**< Slots of a caller provided array of handles */
+    POOL_CHAIN_SOURCE_MMAP,         /**< Anonymous mappings, backed on first touch */
+    POOL_CHAIN_SOURCE_MALLOC        /**< The C heap */
+} TPool_chain_source;
+
+/**
+ * @brief   Pool chain handle
+ */
+typedef struct pool_chain {
+    TPool_handle*      primary;                             /**< Pool tried first */
+    TPool_handle*      chunks[POOL_CHAIN_MAX_CHUNKS];       /**< Overflow chunks sorted by address */
+    uint64             empty_since[POOL_CHAIN_MAX_CHUNKS];  /**< Time chunk i became empty, POOL_CHAIN_IN_USE while it holds blocks */
+    uint32             num_chunks;                          /**< Number of overflow chunks */
+    TPool_chain_source source;                              /**< Source of new chunks */
+    TPool_handle*      reserve;                             /**< Static reserve (POOL_CHAIN_SOURCE_STATIC) */
+    uint32             reserve_count;                       /**< Number of handles in the static reserve */
+    boolean            reserve_taken[POOL_CHAIN_MAX_CHUNKS];/**< Reserve slot i is a chunk of the chain */
+    uint64             cooldown_ns;                         /**< Time a chunk stays empty before it is released */
+} TPool_chain;
+
+/**
+ * @brief   Initialize a pool chain
+ * @param   p_chain         Pointer to the chain handle
+ * @param   p_primary       Pointer to the initialized primary pool
+ * @param   source          Source of overflow chunks
+ * @param   p_reserve       Array of handles for POOL_CHAIN_SOURCE_STATIC, NULL otherwise
+ * @param   reserve_count   Number of handles in p_reserve (at most POOL_CHAIN_MAX_CHUNKS are used)
+ * @param   cooldown_ns     Time an overflow chunk stays empty before it is released
+ * @return  STD_OK on success, STD_NOT_OK on invalid parameters
+ */
+Std_ReturnType pool_chain_init(TPool_chain* p_chain, TPool_handle* p_primary, TPool_chain_source source,
+                               TPool_handle* p_reserve, uint32 reserve_count, uint64 cooldown_ns);
+
+/**
+ * @brief   Allocate a block from the chain
+ * @param   p_chain     Pointer to the chain handle
+ * @return  Pointer to the allocated block, or NULL if no chunk can be added
+ */
+void* pool_chain_alloc(TPool_chain* p_chain);
+
+/**
+ * @brief   Free a block to the pool of the chain that owns it
+ * @param   p_chain     Pointer to the chain handle
+ * @param   p_block     Pointer to the block to free
+ * @return  None
+ * @note    Pointers not owned by the chain are ignored
+ */
+void pool_chain_free(TPool_chain* p_chain, void* p_block);
+
+/**
+ * @brief   Release every overflow chunk whose cooldown has expired
+ * @param   p_chain     Pointer to the chain handle
+ * @return  Number of chunks released
+ * @note    Also runs whenever a chunk becomes empty; call it from a timer to
+ *          release chunks of a chain that has gone quiet
+ */
+uint32 pool_chain_release_idle(TPool_chain* p_chain);
+
+/**
+ * @brief   Release every overflow chunk of the chain
+ * @param   p_chain     Pointer to the chain handle
+ * @return  None
+ * @post    Blocks of overflow chunks are invalid; the primary pool is untouched
+ */
+void pool_chain_deinit(TPool_chain* p_chain);
+
+#endif /* POOL_CHAIN_H */
@@ -0,0 +1,162 @@
+/**
+ * @file        pool_coro.hpp
+ * @brief       C++20 coroutine frame allocation from size-classed pools
+ * @details     FramePools<Pools...> serves coroutine frames from a set of pools of
+ *              increasing block size: a frame goes to the first class whose blocks
+ *              are large enough, or to the next larger class while that one is
+ *              exhausted. Frames larger than the largest block, and frames no class
+ *              can take, come from the global operator new.
+ *
+ *              A promise type gets the pooled frames by deriving from
+ *              pool_frame_promise<frames>, where frames is a FramePools object of
+ *              static storage duration. The classes are any pools with pool_traits,
+ *              i.e. TPool_handle and StaticPool<>.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_CORO_HPP
+#define POOL_CORO_HPP
+
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include "pool.h"
+#include "pool_allocator.hpp"
+
+/**
+ * @brief   Coroutine frame allocator over size-classed pools
+ * @tparam  Pools   Pool types in increasing block size
+ */
+template <typename... Pools>
+class FramePools
+{
+    static_assert(sizeof...(Pools) > 0U, "FramePools needs at least one size class");
+    static_assert(((pool_traits<Pools>::block_align >= __STDCPP_DEFAULT_NEW_ALIGNMENT__) && ...),
+                  "Coroutine frames need the alignment of operator new");
+
+    static constexpr bool ascending() noexcept
+    {
+        constexpr uintptr sizes[] = { pool_traits<Pools>::block_size... };
+        for (std::size_t i = 1U; i < sizeof...(Pools); i++)
+        {
+            if (sizes[i - 1U] >= sizes[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(ascending(), "Size classes must be listed in increasing block size");
+
+public:
+    /** Block size of the largest class; larger frames always come from the heap */
+    static constexpr uintptr max_frame_size = std::get<sizeof...(Pools) - 1U>(std::make_tuple(pool_traits<Pools>::block_size...));
+
+    constexpr explicit FramePools(Pools&... pools) noexcept : pools_(pools...) {}
+
+    FramePools(const FramePools&) = delete;
+    FramePools& operator=(const FramePools&) = delete;
+
+    /**
+     * @brief  Allocate a coroutine frame
+     * @param  size    Frame size requested by the compiler
+     * @return Pointer to the frame
+     * @note   Throws std::bad_alloc only if the heap fallback fails
+     */
+    void* allocate(std::size_t size)
+    {
+        void* p_frame = allocate_from<0U>(size);
+        return (p_frame != nullptr) ? p_frame : ::operator new(size);
+    }
+
+    /**
+     * @brief  Free a coroutine frame
+     * @param  p_frame Pointer returned by allocate()
+     * @param  size    Size passed to allocate()
+     * @note   Only the classes allocate() may have used are checked, with one
+     *         range compare each
+     */
+    void deallocate(void* p_frame, std::size_t size) noexcept
+    {
+        if (!deallocate_to<0U>(p_frame, size))
+        {
+            ::operator delete(p_frame, size);
+        }
+    }
+
+    /**
+     * @brief  Test whether a frame lies in one of the pools
+     * @param  p_frame Pointer to test
+     * @return true if a size class owns the frame, false if it is on the heap
+     */
+    bool owns(const void* p_frame) const noexcept
+    {
+        return std::apply([p_frame](const Pools&... pools) noexcept {
+            return (pool_traits<Pools>::owns(pools, p_frame) || ...);
+        }, pools_);
+    }
+
+private:
+    template <std::size_t I>
+    using traits = pool_traits<std::tuple_element_t<I, std::tuple<Pools...>>>;
+
+    template <std::size_t I>
+    void* allocate_from(std::size_t size) noexcept
+    {
+        if constexpr (I == sizeof...(Pools))
+        {
+            return nullptr;
+        }
+        else
+        {
+            void* p_frame = (size <= traits<I>::block_size) ? traits<I>::allocate(std::get<I>(pools_)) : nullptr;
+            return (p_frame != nullptr) ? p_frame : allocate_from<I + 1U>(size);
+        }
+    }
+
+    template <std::size_t I>
+    bool deallocate_to(void* p_frame, std::size_t size) noexcept
+    {
+        if constexpr (I == sizeof...(Pools))
+        {
+            return false;
+        }
+        else
+        {
+            if ((size <= traits<I>::block_size) && traits<I>::owns(std::get<I>(pools_), p_frame))
+            {
+                traits<I>::deallocate(std::get<I>(pools_), p_frame);
+                return true;
+            }
+            return deallocate_to<I + 1U>(p_frame, size);
+        }
+    }
+
+    std::tuple<Pools&...> pools_;
+};
+
+/**
+ * @brief   Promise type mixin allocating the coroutine frame from a FramePools
+ * @tparam  Frames  FramePools object of static storage duration
+ *
+ * @note    The compiler looks up operator new and operator delete in the promise
+ *          type, so deriving the promise type from this mixin is all it takes:
+ *          `struct promise_type : pool_frame_promise<frames> { ... };`
+ */
+template <auto& Frames>
+struct pool_frame_promise
+{
+    static void* operator new(std::size_t size)
+    {
+        return Frames.allocate(size);
+    }
+
+    static void operator delete(void* p_frame, std::size_t size) noexcept
+    {
+        Frames.deallocate(p_frame, size);
+    }
+};
+
+#endif /* POOL_CORO_HPP */
@@ -0,0 +1,94 @@
+/**
+ * @file        pool_define.h
+ * @brief       Generator for pools specialized at compile time
+ * @details     POOL_DEFINE() emits a dedicated handle type and inline functions for
+ *              one block size and block count, independent of POOL_BLOCK_SIZE and
+ *              POOL_NUM_BLOCKS in pool_cfg.h. Several pools of different geometry can
+ *              live in one binary, and each one gets its size arithmetic and bitmap
+ *              loop bounds folded into constants.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_DEFINE_H
+#define POOL_DEFINE_H
+
+#include "pool_types.h"
+#include "pool_bitmap.h"
+#include "compiler_abstraction.h"
+
+/**
+ * @brief   Define a pool type and its functions for a fixed block size and count
+ * @param   name        Prefix of the generated identifiers
+ * @param   block_size  Size of each block in bytes (integer constant)
+ * @param   num_blocks  Number of blocks (integer constant)
+ * @details Generates, for POOL_DEFINE(small, 32U, 64U):
+ *          - TPool_small                           handle type; all zero is an empty pool,
+ *                                                  so static instances need no initialization
+ *          - void  small_init(TPool_small*)        mark every block free
+ *          - void* small_alloc(TPool_small*)       first free block, NULL if exhausted
+ *          - void  small_free(TPool_small*, void*) NULL, foreign, misaligned and already
+ *                                                  free pointers are ignored
+ *          - uintptr small_free_count(const TPool_small*)
+ *          The functions are static inline, so use the macro once per translation unit
+ *          that needs the pool, or in a header shared by them.
+ */
+#define POOL_DEFINE(name, block_size, num_blocks) \
+    _Static_assert(((block_size) > 0U) && ((num_blocks) > 0U), "POOL_DEFINE needs a non-empty pool"); \
+    \
+    typedef struct name##_pool { \
+        uint8      memory[(uint64)(num_blocks) * (uint64)(block_size)] ATTR_ALIGNED(POOL_MEMORY_ALIGN); \
+        TPool_word bitmap[((num_blocks) + (POOL_WORD_BITS - 1U)) / POOL_WORD_BITS]; \
+        uintptr    hint;    /* Lowest bitmap word that may hold a free block */ \
+        uintptr    used;    /* Number of allocated blocks */ \
+    } TPool_##name; \
+    \
+    LOCAL_INLINE void name##_init(TPool_##name* p_pool) \
+    { \
+        uintptr i; \
+        for (i = 0U; i < (sizeof(p_pool->bitmap) / sizeof(p_pool->bitmap[0])); i++) \
+        { \
+            p_pool->bitmap[i] = 0U; \
+        } \
+        p_pool->hint = 0U; \
+        p_pool->used = 0U; \
+    } \
+    \
+    LOCAL_INLINE void* name##_alloc(TPool_##name* p_pool) \
+    { \
+        uintptr index = pool_bitmap_find_free(p_pool->bitmap, (num_blocks), p_pool->hint); \
+        if (UNLIKELY(index >= (uintptr)(num_blocks))) \
+        { \
+            p_pool->hint = (((num_blocks) + (POOL_WORD_BITS - 1U)) / POOL_WORD_BITS) - 1U; \
+            return NULL_PTR; \
+        } \
+        p_pool->hint = index / POOL_WORD_BITS; \
+        pool_bit_set(p_pool->bitmap, index); \
+        p_pool->used++; \
+        return &p_pool->memory[index * (block_size)]; \
+    } \
+    \
+    LOCAL_INLINE void name##_free(TPool_##name* p_pool, void* p_block) \
+    { \
+        uintptr offset = (uintptr)p_block - (uintptr)p_pool->memory; \
+        uintptr index = offset / (block_size); \
+        if (UNLIKELY((offset >= sizeof(p_pool->memory)) || (0U != (offset % (block_size))) || \
+                     (0U == pool_bit_test(p_pool->bitmap, index)))) \
+        { \
+            return; \
+        } \
+        pool_bit_clear(p_pool->bitmap, index); \
+        p_pool->used--; \
+        if ((index / POOL_WORD_BITS) < p_pool->hint) \
+        { \
+            p_pool->hint = index / POOL_WORD_BITS; \
+        } \
+    } \
+    \
+    LOCAL_INLINE uintptr name##_free_count(const TPool_##name* p_pool) \
+    { \
+        return (uintptr)(num_blocks) - p_pool->used; \
+    }
+
+#endif /* POOL_DEFINE_H */
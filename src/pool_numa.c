@@ -0,0 +1,125 @@
+/**
+ * @file        pool_numa.c
+ * @brief       NUMA front-end over one memory pool per node
+ * @details     Node lookup uses getcpu(), binding uses mbind(); both go through the
+ *              pool_os layer, which reports a single node where NUMA is unavailable.
+ */
+
+#include "pool_numa.h"
+#include "pool.h"
+#include "pool_os.h"
+
+/**
+ * @brief Initialize a NUMA front-end
+ * 
+ * @param p_numa    Pointer to the front-end handle
+ * @param pools     Pools to use, one per node
+ * @param num_pools Number of pools
+ * @param mode      How every pool is initialized
+ * @param prefault  TRUE to fault in every pool on its node
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK on invalid parameters
+ * 
+ * @note  - Pool i is bound to node i before it is initialized, so the pages it
+ *          faults in come from that node
+ *        - POOL_INIT_FULL already writes every page, so prefault is skipped
+ *        - On a machine with fewer nodes than pools the extra pools stay unbound
+ *          and callers are routed by node modulo the number of pools
+ */
+Std_ReturnType pool_numa_init(TPool_numa* p_numa, TPool_handle* const pools[], uint32 num_pools,
+                              TPool_init_mode mode, boolean prefault)
+{
+    uint32 node_count = pool_os_numa_node_count();
+    uint32 i;
+
+    if ((NULL_PTR == p_numa) || (NULL_PTR == pools) || (0U == num_pools) || (num_pools > POOL_NUMA_MAX_NODES))
+    {
+        return STD_NOT_OK;
+    }
+
+    for (i = 0U; i < num_pools; i++)
+    {
+        if (NULL_PTR == pools[i])
+        {
+            return STD_NOT_OK;
+        }
+    }
+
+    for (i = 0U; i < num_pools; i++)
+    {
+        if (i < node_count)
+        {
+            (void)pool_bind_node(pools[i], i);
+        }
+        pool_init_ex(pools[i], mode);
+        if ((TRUE == prefault) && (POOL_INIT_FULL != mode))
+        {
+            (void)pool_prefault(pools[i], FALSE, 1U);
+        }
+        p_numa->pools[i] = pools[i];
+    }
+    p_numa->num_pools = num_pools;
+
+    return STD_OK;
+}
+
+/**
+ * @brief Allocate a block from the pool of the caller's node
+ * 
+ * @param p_numa Pointer to the front-end handle
+ * @return void* Pointer to the allocated block, or NULL if every pool is exhausted
+ * 
+ * @note  - Returns NULL if p_numa is NULL
+ *        - Remote pools are only tried after the local one is exhausted
+ */
+void* pool_numa_alloc(TPool_numa* p_numa)
+{
+    uint32 local;
+    uint32 i;
+
+    if (NULL_PTR == p_numa)
+    {
+        return NULL_PTR;
+    }
+
+    local = pool_os_numa_current_node() % p_numa->num_pools;
+
+    for (i = 0U; i < p_numa->num_pools; i++)
+    {
+        void* block = pool_alloc_fast(p_numa->pools[(local + i) % p_numa->num_pools]);
+        if (NULL_PTR != block)
+        {
+            return block;
+        }
+    }
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief Free a block to the pool that owns it
+ * 
+ * @param p_numa  Pointer to the front-end handle
+ * @param p_block Pointer to the block to free
+ * 
+ * @note  - The owner is found by comparing the address with the memory area of
+ *          each pool, at most POOL_NUMA_MAX_NODES compares
+ */
+void pool_numa_free(TPool_numa* p_numa, void* p_block)
+{
+    uint32 i;
+
+    if ((NULL_PTR == p_numa) || (NULL_PTR == p_block))
+    {
+        return;
+    }
+
+    for (i = 0U; i < p_numa->num_pools; i++)
+    {
+        TPool_handle* pool = p_numa->pools[i];
+        if (((uint8*)p_block >= pool->memory) && ((uint8*)p_block < (pool->memory + sizeof(pool->memory))))
+        {
+            pool_free(pool, p_block);
+            return;
+        }
+    }
+}
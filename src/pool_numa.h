@@ -0,0 +1,65 @@
+/**
+ * @file        pool_numa.h
+ * @brief       NUMA front-end over one memory pool per node
+ * @details     The front-end owns one pool per NUMA node, binds each pool's memory
+ *              area to its node and routes every allocation to the pool of the node
+ *              the caller runs on. Frees go back to the pool that owns the block,
+ *              whichever node the caller is on.
+ *
+ * @note        Each node pool needs the same external synchronization as a single
+ *              pool if it is used by more than one thread.
+ *
+ *              Only whole pages are bound to a node. Pools that are smaller than a
+ *              page or share pages with each other stay where first touch puts them,
+ *              so give every node pool its own page-aligned storage.
+ */
+
+#ifndef POOL_NUMA_H
+#define POOL_NUMA_H
+
+#include "pool_types.h"
+
+/**
+ * @brief   NUMA front-end handle
+ */
+typedef struct pool_numa {
+    TPool_handle* pools[POOL_NUMA_MAX_NODES];   /**< Pool serving node i (node modulo num_pools) */
+    uint32        num_pools;                    /**< Number of pools in use */
+} TPool_numa;
+
+/**
+ * @brief   Initialize a NUMA front-end
+ * @param   p_numa      Pointer to the front-end handle
+ * @param   pools       Pools to use, one per node; pool i is placed on node i
+ * @param   num_pools   Number of pools (1 to POOL_NUMA_MAX_NODES)
+ * @param   mode        How every pool is initialized, see pool_init_ex()
+ * @param   prefault    TRUE to make every pool resident on its node right away
+ * @return  STD_OK on success, STD_NOT_OK on invalid parameters
+ * @pre     With POOL_INIT_METADATA or POOL_INIT_ZEROED the pool handles must be
+ *          zero-initialized storage, e.g. static handles in .bss
+ * @post    Every pool is initialized; pools for nodes that do not exist are left unbound
+ * @note    POOL_INIT_FULL writes, and so faults in, every page of each pool on its
+ *          node whatever prefault says. With the other modes nothing is touched, and
+ *          prefault chooses between faulting the pages in now and on first use.
+ */
+Std_ReturnType pool_numa_init(TPool_numa* p_numa, TPool_handle* const pools[], uint32 num_pools,
+                              TPool_init_mode mode, boolean prefault);
+
+/**
+ * @brief   Allocate a block from the pool of the caller's node
+ * @param   p_numa  Pointer to the front-end handle
+ * @return  Pointer to the allocated block, or NULL if every pool is exhausted
+ * @note    Falls over to the pools of the other nodes when the local one is exhausted
+ */
+void* pool_numa_alloc(TPool_numa* p_numa);
+
+/**
+ * @brief   Free a block to the pool that owns it
+ * @param   p_numa  Pointer to the front-end handle
+ * @param   p_block Pointer to the block to free
+ * @return  None
+ * @note    Pointers not owned by any pool are ignored
+ */
+void pool_numa_free(TPool_numa* p_numa, void* p_block);
+
+#endif /* POOL_NUMA_H */
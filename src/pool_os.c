@@ -0,0 +1,548 @@
+/**
+ * @file        pool_os.c
+ * @brief       Operating system services used by the memory pool
+ * @details     POSIX implementation with a fallback for bare-metal targets.
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE  /* MADV_* constants, getcpu() */
+#endif
+
+#include "pool_os.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#define POOL_OS_POSIX
+#endif
+
+#if defined(__linux__)
+#include <stdio.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <errno.h>
+#include <linux/futex.h>
+
+/* Memory policy constants of <linux/mempolicy.h>, used through the raw syscall
+ * so that libnuma is not required */
+#define MPOL_BIND_MODE           (2)
+#define MPOL_MF_MOVE_FLAG        (1U << 1)
+
+/* Largest node number handled by pool_os_numa_bind() plus one */
+#define NUMA_MAX_NODES           (64U)
+#endif
+
+/**
+ * @brief Smallest share of a parallel populate given to one thread
+ * @details Below this size creating a thread costs more than faulting the pages.
+ */
+#define POPULATE_MIN_PER_THREAD  (16UL * 1024UL * 1024UL)
+
+/**
+ * @brief Upper bound of threads used by pool_os_populate()
+ */
+#define POPULATE_MAX_THREADS     (64U)
+
+/**
+ * @brief Sleep interval of pool_os_futex_wait() on targets without futexes
+ */
+#define FUTEX_POLL_NS            (1000000ULL)
+
+/**
+ * @brief Get the virtual memory page size
+ * 
+ * @return uintptr Page size in bytes, or 0 without paged virtual memory
+ */
+uintptr pool_os_page_size(void)
+{
+#if defined(POOL_OS_POSIX)
+    static uintptr page_size = 0U;
+
+    if (0U == page_size)
+    {
+        long result = sysconf(_SC_PAGESIZE);
+        page_size = (result > 0) ? (uintptr)result : 0U;
+    }
+    return page_size;
+#else
+    return 0U;
+#endif
+}
+
+/**
+ * @brief Return the physical pages backing a page-aligned range to the system
+ * 
+ * @param addr Page-aligned start address
+ * @param size Size in bytes, a multiple of the page size
+ * @param lazy TRUE to use MADV_FREE where available
+ * @return Std_ReturnType STD_OK if the advice was accepted
+ * 
+ * @note  - MADV_DONTNEED drops the pages immediately; private anonymous pages read
+ *          back as zero
+ *        - MADV_FREE only marks them reclaimable, which is cheaper when the pool
+ *          fills up again before the system needs the memory
+ */
+Std_ReturnType pool_os_release(void* addr, uintptr size, boolean lazy)
+{
+#if defined(POOL_OS_POSIX)
+    int advice = MADV_DONTNEED;
+
+#if defined(MADV_FREE)
+    if (TRUE == lazy)
+    {
+        advice = MADV_FREE;
+    }
+#else
+    (void)lazy;
+#endif
+
+    return (0 == madvise(addr, size, advice)) ? STD_OK : STD_NOT_OK;
+#else
+    (void)addr;
+    (void)size;
+    (void)lazy;
+    return STD_NOT_OK;
+#endif
+}
+
+#if defined(POOL_OS_POSIX)
+/**
+ * @brief Share of a parallel populate handled by one thread
+ */
+typedef struct populate_job {
+    uint8*  start;  /**< First byte of the share */
+    uintptr size;   /**< Size of the share in bytes */
+} TPopulate_job;
+
+/**
+ * @brief Fault in one share of the range
+ * @param arg Pointer to the TPopulate_job describing the share
+ * 
+ * @details Asks the kernel to populate the pages first (MADV_POPULATE_WRITE,
+ *          Linux 5.14+), which avoids one fault per page. Older kernels reject
+ *          the advice and every page is written instead, storing back the byte
+ *          that was read so the contents do not change.
+ */
+static void* populate_share(void* arg)
+{
+    TPopulate_job* job = (TPopulate_job*)arg;
+    uintptr page_size = pool_os_page_size();
+    uintptr first = (uintptr)job->start & ~(page_size - 1U);
+    uintptr end = ((uintptr)job->start + job->size + (page_size - 1U)) & ~(page_size - 1U);
+    volatile uint8* page;
+
+#if defined(MADV_POPULATE_WRITE)
+    if (0 == madvise((void*)first, end - first, MADV_POPULATE_WRITE))
+    {
+        return NULL_PTR;
+    }
+#else
+    (void)first;
+    (void)end;
+#endif
+
+    for (page = job->start; page < (job->start + job->size); page = (volatile uint8*)(((uintptr)page + page_size) & ~(page_size - 1U)))
+    {
+        *page = *page;
+    }
+
+    return NULL_PTR;
+}
+#endif
+
+/**
+ * @brief Fault in every page of a range for writing
+ * 
+ * @param addr        Start address, need not be page aligned
+ * @param size        Size in bytes
+ * @param num_threads Maximum number of threads sharing the work
+ * @return Std_ReturnType STD_OK if every page is resident
+ * 
+ * @note  - The range is split into shares of at least POPULATE_MIN_PER_THREAD
+ *          bytes whose boundaries are page aligned, so no page is touched by two
+ *          threads; the first share also covers the part of the first page
+ *          before addr, and the caller handles the last share
+ *        - If a thread cannot be created its share is handled by the caller
+ *        - Concurrent writers to the range may lose updates while the fallback
+ *          touch loop runs, so populate before the memory is in use
+ */
+Std_ReturnType pool_os_populate(void* addr, uintptr size, uint32 num_threads)
+{
+#if defined(POOL_OS_POSIX)
+    TPopulate_job jobs[POPULATE_MAX_THREADS];
+    pthread_t threads[POPULATE_MAX_THREADS];
+    boolean started[POPULATE_MAX_THREADS];
+    uintptr page_size = pool_os_page_size();
+    uintptr share;
+    uint8* base;
+    uint8* end = (uint8*)addr + size;
+    uint32 count;
+    uint32 i;
+
+    if ((NULL_PTR == addr) || (0U == size) || (0U == page_size))
+    {
+        return STD_NOT_OK;
+    }
+
+    /* Number of shares: bounded by the request, the limit and the minimum share */
+    count = (num_threads > 1U) ? num_threads : 1U;
+    count = (count > POPULATE_MAX_THREADS) ? POPULATE_MAX_THREADS : count;
+    if ((size / POPULATE_MIN_PER_THREAD) < count)
+    {
+        count = (uint32)(size / POPULATE_MIN_PER_THREAD);
+        count = (count > 1U) ? count : 1U;
+    }
+    /* Boundaries are multiples of the share from the page below addr */
+    base = (uint8*)((uintptr)addr & ~(page_size - 1U));
+    share = ((((uintptr)(end - base)) / count) + (page_size - 1U)) & ~(page_size - 1U);
+
+    for (i = 0U; i < count; i++)
+    {
+        uint8* share_end = ((uintptr)(end - base) > ((i + 1U) * share)) ? (base + ((i + 1U) * share)) : end;
+
+        jobs[i].start = (0U == i) ? (uint8*)addr : (base + (i * share));
+        jobs[i].size = (share_end > jobs[i].start) ? (uintptr)(share_end - jobs[i].start) : 0U;
+
+        /* The caller takes the last share itself */
+        started[i] = (boolean)((i + 1U < count) && (0U != jobs[i].size) &&
+                               (0 == pthread_create(&threads[i], NULL_PTR, populate_share, &jobs[i])));
+    }
+
+    for (i = 0U; i < count; i++)
+    {
+        if (TRUE == started[i])
+        {
+            pthread_join(threads[i], NULL_PTR);
+        }
+        else if (0U != jobs[i].size)
+        {
+            (void)populate_share(&jobs[i]);
+        }
+    }
+
+    return STD_OK;
+#else
+    (void)addr;
+    (void)size;
+    (void)num_threads;
+    return STD_NOT_OK;
+#endif
+}
+
+/**
+ * @brief Lock the pages of a range into physical memory
+ * 
+ * @param addr Start address, need not be page aligned
+ * @param size Size in bytes
+ * @return Std_ReturnType STD_OK if the pages are locked
+ */
+Std_ReturnType pool_os_lock(void* addr, uintptr size)
+{
+#if defined(POOL_OS_POSIX)
+    return (0 == mlock(addr, size)) ? STD_OK : STD_NOT_OK;
+#else
+    (void)addr;
+    (void)size;
+    return STD_NOT_OK;
+#endif
+}
+
+/**
+ * @brief Get the number of NUMA nodes of the system
+ * 
+ * @return uint32 Highest online node number plus one, 1 without NUMA support
+ * 
+ * @note  - Reads /sys/devices/system/node/online once (e.g. "0-1" or "0,2")
+ */
+uint32 pool_os_numa_node_count(void)
+{
+#if defined(__linux__)
+    static uint32 node_count = 0U;
+
+    if (0U == node_count)
+    {
+        FILE* file = fopen("/sys/devices/system/node/online", "r");
+        int node;
+        int separator;
+        uint32 highest = 0U;
+
+        if (NULL_PTR != file)
+        {
+            /* Ranges and lists: the last number read is the highest node */
+            while (1 == fscanf(file, "%d", &node))
+            {
+                highest = ((uint32)node > highest) ? (uint32)node : highest;
+                separator = fgetc(file);
+                if ((',' != separator) && ('-' != separator))
+                {
+                    break;
+                }
+            }
+            fclose(file);
+        }
+        node_count = (highest < NUMA_MAX_NODES) ? (highest + 1U) : NUMA_MAX_NODES;
+    }
+    return node_count;
+#else
+    return 1U;
+#endif
+}
+
+/**
+ * @brief Get the NUMA node of the CPU the caller is running on
+ * 
+ * @return uint32 Node number, 0 without NUMA support or if the call fails
+ * 
+ * @note  - glibc 2.29+ answers getcpu() from the vDSO or rseq area without
+ *          entering the kernel; older C libraries fall back to the raw syscall
+ */
+uint32 pool_os_numa_current_node(void)
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0U;
+    unsigned int node = 0U;
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 29)))
+    if (0 != getcpu(&cpu, &node))
+#else
+    if (0 != syscall(SYS_getcpu, &cpu, &node, NULL_PTR))
+#endif
+    {
+        return 0U;
+    }
+    return (uint32)node;
+#else
+    return 0U;
+#endif
+}
+
+/**
+ * @brief Bind the pages of a range to one NUMA node
+ * 
+ * @param addr Start address, need not be page aligned
+ * @param size Size in bytes
+ * @param node Node number
+ * @return Std_ReturnType STD_OK if the policy was applied
+ * 
+ * @note  - Only the whole pages inside the range are bound: pages it shares with
+ *          neighbouring data keep their policy, so binding one of two adjacent
+ *          pools never moves the pages of the other. A range without a whole page
+ *          is not bound at all.
+ *        - Uses mbind(MPOL_BIND) through the raw syscall with MPOL_MF_MOVE, so
+ *          pages that are already resident and not shared are migrated
+ */
+Std_ReturnType pool_os_numa_bind(void* addr, uintptr size, uint32 node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long nodemask[(NUMA_MAX_NODES + ((sizeof(unsigned long) * 8U) - 1U)) / (sizeof(unsigned long) * 8U)] = { 0UL };
+    uintptr page_size = pool_os_page_size();
+    uintptr first;
+    uintptr end;
+
+    if ((NULL_PTR == addr) || (0U == size) || (node >= pool_os_numa_node_count()))
+    {
+        return STD_NOT_OK;
+    }
+
+    first = ((uintptr)addr + (page_size - 1U)) & ~(page_size - 1U);
+    end = ((uintptr)addr + size) & ~(page_size - 1U);
+    if (end <= first)
+    {
+        return STD_NOT_OK;
+    }
+    nodemask[node / (sizeof(unsigned long) * 8U)] = 1UL << (node % (sizeof(unsigned long) * 8U));
+
+    if (0 != syscall(SYS_mbind, first, end - first, MPOL_BIND_MODE, nodemask, (unsigned long)NUMA_MAX_NODES + 1UL, MPOL_MF_MOVE_FLAG))
+    {
+        return STD_NOT_OK;
+    }
+    return STD_OK;
+#else
+    (void)addr;
+    (void)size;
+    (void)node;
+    return STD_NOT_OK;
+#endif
+}
+
+/**
+ * @brief Reserve an inaccessible range of address space
+ * 
+ * @param size Size in bytes, a multiple of the page size
+ * @return void* Start of the range, or NULL if it cannot be reserved
+ * 
+ * @note  - MAP_NORESERVE keeps the reservation out of the commit charge where
+ *          the kernel supports it
+ */
+void* pool_os_reserve(uintptr size)
+{
+#if defined(POOL_OS_POSIX)
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* addr;
+
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif
+    addr = mmap(NULL_PTR, size, PROT_NONE, flags, -1, 0);
+    return (MAP_FAILED == addr) ? NULL_PTR : addr;
+#else
+    (void)size;
+    return NULL_PTR;
+#endif
+}
+
+/**
+ * @brief Make part of a reserved range readable and writable
+ * 
+ * @param addr Page-aligned start address inside a reserved range
+ * @param size Size in bytes, a multiple of the page size
+ * @return Std_ReturnType STD_OK on success
+ */
+Std_ReturnType pool_os_commit(void* addr, uintptr size)
+{
+#if defined(POOL_OS_POSIX)
+    return (0 == mprotect(addr, size, PROT_READ | PROT_WRITE)) ? STD_OK : STD_NOT_OK;
+#else
+    (void)addr;
+    (void)size;
+    return STD_NOT_OK;
+#endif
+}
+
+/**
+ * @brief Map a readable and writable range backed on first touch
+ * 
+ * @param size Size in bytes, a multiple of the page size
+ * @return void* Start of the zero filled range, or NULL on failure
+ */
+void* pool_os_map(uintptr size)
+{
+#if defined(POOL_OS_POSIX)
+    void* addr = mmap(NULL_PTR, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (MAP_FAILED == addr) ? NULL_PTR : addr;
+#else
+    (void)size;
+    return NULL_PTR;
+#endif
+}
+
+/**
+ * @brief Return a range obtained from pool_os_reserve() or pool_os_map()
+ * 
+ * @param addr Start of the range
+ * @param size Size in bytes used when it was obtained
+ */
+void pool_os_unmap(void* addr, uintptr size)
+{
+#if defined(POOL_OS_POSIX)
+    (void)munmap(addr, size);
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/**
+ * @brief Read a monotonic clock
+ * 
+ * @return uint64 Time in nanoseconds, or 0 if no clock is available
+ */
+uint64 pool_os_now_ns(void)
+{
+#if defined(POOL_OS_POSIX)
+    struct timespec now;
+
+    if (0 != clock_gettime(CLOCK_MONOTONIC, &now))
+    {
+        return 0U;
+    }
+    return ((uint64)now.tv_sec * 1000000000ULL) + (uint64)now.tv_nsec;
+#else
+    return 0U;
+#endif
+}
+
+/**
+ * @brief Sleep while a 32-bit word holds an expected value
+ * 
+ * @param addr       Address of the word
+ * @param expected   Value the word must still hold for the caller to sleep
+ * @param timeout_ns Maximum sleep time in nanoseconds, ~0 to sleep until woken
+ * @return Std_ReturnType STD_OK if woken or the word changed, STD_NOT_OK on timeout
+ * 
+ * @note  - Linux: FUTEX_WAIT_PRIVATE with a relative timeout
+ *        - Other POSIX targets poll: they sleep for at most FUTEX_POLL_NS
+ */
+Std_ReturnType pool_os_futex_wait(uint32* addr, uint32 expected, uint64 timeout_ns)
+{
+#if defined(__linux__)
+    struct timespec timeout;
+    struct timespec* p_timeout = NULL;
+
+    if (~0ULL != timeout_ns)
+    {
+        timeout.tv_sec = (time_t)(timeout_ns / 1000000000ULL);
+        timeout.tv_nsec = (long)(timeout_ns % 1000000000ULL);
+        p_timeout = &timeout;
+    }
+    if ((0 != syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, p_timeout, NULL, 0)) &&
+        (ETIMEDOUT == errno))
+    {
+        return STD_NOT_OK;
+    }
+    return STD_OK;
+#elif defined(POOL_OS_POSIX)
+    struct timespec pause;
+    uint64 sleep_ns = (timeout_ns < FUTEX_POLL_NS) ? timeout_ns : FUTEX_POLL_NS;
+
+    if (__atomic_load_n(addr, __ATOMIC_ACQUIRE) != expected)
+    {
+        return STD_OK;
+    }
+    pause.tv_sec = 0;
+    pause.tv_nsec = (long)sleep_ns;
+    (void)nanosleep(&pause, NULL);
+    return (sleep_ns < FUTEX_POLL_NS) ? STD_NOT_OK : STD_OK;
+#else
+    (void)addr;
+    (void)expected;
+    (void)timeout_ns;
+    return STD_NOT_OK;
+#endif
+}
+
+/**
+ * @brief Wake threads sleeping in pool_os_futex_wait() on a word
+ * 
+ * @param addr  Address of the word
+ * @param count Maximum number of threads to wake
+ */
+void pool_os_futex_wake(uint32* addr, uint32 count)
+{
+#if defined(__linux__)
+    (void)syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, (int)count, NULL, NULL, 0);
+#else
+    (void)addr;  /* Pollers notice the change of the word */
+    (void)count;
+#endif
+}
+
+/**
+ * @brief Add one to the counter of an eventfd
+ * 
+ * @param fd eventfd file descriptor
+ * @return Std_ReturnType STD_OK if the event was signalled, STD_NOT_OK otherwise
+ */
+Std_ReturnType pool_os_event_signal(sint32 fd)
+{
+#if defined(POOL_OS_POSIX)
+    uint64 one = 1U;
+
+    return ((ssize_t)sizeof(one) == write(fd, &one, sizeof(one))) ? STD_OK : STD_NOT_OK;
+#else
+    (void)fd;
+    return STD_NOT_OK;
+#endif
+}
@@ -0,0 +1,140 @@
+/**
+ * @file        pool_os.h
+ * @brief       Operating system services used by the memory pool
+ * @details     Thin wrappers around the virtual memory services of the host. On
+ *              targets without an MMU or operating system the functions report that
+ *              the service is unavailable and the pool keeps working without it.
+ *              These functions are internal to the pool implementation.
+ */
+
+#ifndef POOL_OS_H
+#define POOL_OS_H
+
+#include "std_types.h"
+
+/**
+ * @brief   Get the virtual memory page size
+ * @return  Page size in bytes, or 0 if the target has no paged virtual memory
+ */
+uintptr pool_os_page_size(void);
+
+/**
+ * @brief   Return the physical pages backing a page-aligned range to the system
+ * @param   addr    Page-aligned start address
+ * @param   size    Size in bytes, a multiple of the page size
+ * @param   lazy    TRUE to let the kernel reclaim the pages only under memory pressure
+ * @return  STD_OK if the pages were released, STD_NOT_OK otherwise
+ * @note    The contents of the range are lost; later accesses fault in fresh pages
+ */
+Std_ReturnType pool_os_release(void* addr, uintptr size, boolean lazy);
+
+/**
+ * @brief   Fault in every page of a range for writing
+ * @param   addr        Start address, need not be page aligned
+ * @param   size        Size in bytes
+ * @param   num_threads Maximum number of threads sharing the work (0 or 1 = caller only)
+ * @return  STD_OK if every page is resident, STD_NOT_OK otherwise
+ * @note    The contents of the range are preserved
+ */
+Std_ReturnType pool_os_populate(void* addr, uintptr size, uint32 num_threads);
+
+/**
+ * @brief   Lock the pages of a range into physical memory
+ * @param   addr    Start address, need not be page aligned
+ * @param   size    Size in bytes
+ * @return  STD_OK if the pages are locked, STD_NOT_OK otherwise (e.g. RLIMIT_MEMLOCK)
+ */
+Std_ReturnType pool_os_lock(void* addr, uintptr size);
+
+/**
+ * @brief   Get the number of NUMA nodes of the system
+ * @return  Highest online node number plus one; 1 without NUMA support
+ */
+uint32 pool_os_numa_node_count(void);
+
+/**
+ * @brief   Get the NUMA node of the CPU the caller is running on
+ * @return  Node number; 0 without NUMA support
+ * @note    The thread may migrate right after the call, so the result is a hint
+ */
+uint32 pool_os_numa_current_node(void);
+
+/**
+ * @brief   Bind the pages of a range to one NUMA node
+ * @param   addr    Start address, need not be page aligned
+ * @param   size    Size in bytes
+ * @param   node    Node number
+ * @return  STD_OK if the policy was applied, STD_NOT_OK otherwise or if the range
+ *          contains no whole page
+ * @note    Only whole pages inside the range are bound; partial pages at either end
+ *          are shared with other data and keep their policy. Pages already faulted
+ *          in are migrated when possible.
+ */
+Std_ReturnType pool_os_numa_bind(void* addr, uintptr size, uint32 node);
+
+/**
+ * @brief   Reserve an inaccessible range of address space
+ * @param   size    Size in bytes, a multiple of the page size
+ * @return  Start of the range, or NULL if it cannot be reserved
+ * @note    No memory is committed; every access faults until pool_os_commit()
+ */
+void* pool_os_reserve(uintptr size);
+
+/**
+ * @brief   Make part of a reserved range readable and writable
+ * @param   addr    Page-aligned start address inside a reserved range
+ * @param   size    Size in bytes, a multiple of the page size
+ * @return  STD_OK on success, STD_NOT_OK otherwise
+ * @note    Physical pages are still only backed on first write
+ */
+Std_ReturnType pool_os_commit(void* addr, uintptr size);
+
+/**
+ * @brief   Map a readable and writable range backed on first touch
+ * @param   size    Size in bytes, a multiple of the page size
+ * @return  Start of the range (zero filled), or NULL on failure
+ */
+void* pool_os_map(uintptr size);
+
+/**
+ * @brief   Return a range obtained from pool_os_reserve() or pool_os_map()
+ * @param   addr    Start of the range
+ * @param   size    Size in bytes used when it was obtained
+ * @return  None
+ */
+void pool_os_unmap(void* addr, uintptr size);
+
+/**
+ * @brief   Read a monotonic clock
+ * @return  Time in nanoseconds since an arbitrary start, or 0 if no clock is available
+ */
+uint64 pool_os_now_ns(void);
+
+/**
+ * @brief   Sleep while a 32-bit word holds an expected value
+ * @param   addr        Address of the word, shared between the threads
+ * @param   expected    Value the word must still hold for the caller to sleep
+ * @param   timeout_ns  Maximum sleep time in nanoseconds, ~0 to sleep until woken
+ * @return  STD_OK if woken or the word changed, STD_NOT_OK on timeout
+ * @note    May return early (spurious wakeup); callers re-check their condition.
+ *          Without futexes the caller sleeps for a short interval instead.
+ */
+Std_ReturnType pool_os_futex_wait(uint32* addr, uint32 expected, uint64 timeout_ns);
+
+/**
+ * @brief   Wake threads sleeping in pool_os_futex_wait() on a word
+ * @param   addr    Address of the word
+ * @param   count   Maximum number of threads to wake
+ * @return  None
+ */
+void pool_os_futex_wake(uint32* addr, uint32 count);
+
+/**
+ * @brief   Add one to the counter of an eventfd
+ * @param   fd      eventfd file descriptor
+ * @return  STD_OK if the event was signalled, STD_NOT_OK otherwise
+ * @note    Never blocks; an eventfd whose counter is about to overflow reports STD_NOT_OK
+ */
+Std_ReturnType pool_os_event_signal(sint32 fd);
+
+#endif /* POOL_OS_H */
@@ -0,0 +1,167 @@
+/**
+ * @file        pool_ptr.hpp
+ * @brief       Smart pointers owning objects in pool blocks
+ * @details     pool_unique_ptr<T> is a std::unique_ptr whose deleter is stateless:
+ *              it finds the owning pool of the object through the global registry
+ *              (pool_registry.h), so the smart pointer is as small as a raw pointer.
+ *
+ *              pool_allocate_shared<T>() is std::allocate_shared() with a
+ *              PoolAllocator. The standard library makes a single allocation holding
+ *              both the control block and the object; when that fits one block it
+ *              comes from the pool, so shared ownership needs no heap allocation.
+ *
+ *              Objects that do not fit a block, or that are created while the pool is
+ *              exhausted, are allocated from the heap and released there.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_PTR_HPP
+#define POOL_PTR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "pool.h"
+#include "pool_registry.h"
+#include "pool_allocator.hpp"
+
+namespace pool_ptr_detail
+{
+    /**
+     * @brief Give the storage of a T back to the registered pool owning it, or to the heap
+     */
+    template <typename T>
+    void release(void* p_block) noexcept
+    {
+        TPool_handle* p_handle = pool_owns(p_block);
+
+        if (p_handle != nullptr)
+        {
+            pool_free(p_handle, p_block);
+        }
+        else if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(p_block, std::align_val_t{alignof(T)});
+        }
+        else
+        {
+            ::operator delete(p_block);
+        }
+    }
+}
+
+/**
+ * @brief   Deleter of pool_unique_ptr
+ * @details Destroys the object and gives its block back to the registered pool that
+ *          owns it, or to the heap if no registered pool does.
+ *
+ *          A pool_unique_ptr<Derived> converts to pool_unique_ptr<Base> only when Base
+ *          has a virtual destructor and the heap fallback would use the same alignment
+ *          for both. The block start is then recovered with dynamic_cast<void*>, since
+ *          a Base that is not the first base does not sit at the start of the block.
+ */
+template <typename T>
+struct pool_deleter
+{
+    constexpr pool_deleter() noexcept = default;
+
+    template <typename U>
+        requires (std::is_convertible_v<U*, T*> &&
+                  (std::is_same_v<std::remove_cv_t<U>, std::remove_cv_t<T>> ||
+                   std::has_virtual_destructor_v<T>) &&
+                  (((alignof(U) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) &&
+                    (alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)) ||
+                   (alignof(U) == alignof(T))))
+    pool_deleter(const pool_deleter<U>&) noexcept {}
+
+    void operator()(T* p_object) const noexcept
+    {
+        void* p_block;
+
+        if constexpr (std::is_polymorphic_v<T>)
+        {
+            p_block = const_cast<void*>(dynamic_cast<const volatile void*>(p_object));
+        }
+        else
+        {
+            p_block = const_cast<void*>(static_cast<const volatile void*>(p_object));
+        }
+
+        p_object->~T();
+        pool_ptr_detail::release<T>(p_block);
+    }
+};
+
+/**
+ * @brief   Unique pointer to an object in a pool block
+ */
+template <typename T>
+using pool_unique_ptr = std::unique_ptr<T, pool_deleter<T>>;
+
+/**
+ * @brief   Create an object in a block of a registered pool
+ * @param   pool    Pool registered with pool_register()
+ * @param   args    Constructor arguments
+ * @return  Owning pointer to the new object
+ * @note    Falls back to the heap if T does not fit a block, the pool is exhausted
+ *          or not registered (the deleter could not find it otherwise); throws
+ *          std::bad_alloc only if the heap is exhausted too
+ */
+template <typename T, typename... Args>
+pool_unique_ptr<T> pool_make_unique(TPool_handle& pool, Args&&... args)
+{
+    void* p_block = nullptr;
+
+    if constexpr ((sizeof(T) <= pool_traits<TPool_handle>::block_size) &&
+                  (alignof(T) <= pool_traits<TPool_handle>::block_align))
+    {
+        p_block = pool_alloc_fast(&pool);
+        if ((p_block != nullptr) && (pool_owns(p_block) != &pool)) [[unlikely]]
+        {
+            pool_free(&pool, p_block);  /* Not registered */
+            p_block = nullptr;
+        }
+    }
+
+    if (p_block == nullptr)
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            p_block = ::operator new(sizeof(T), std::align_val_t{alignof(T)});
+        }
+        else
+        {
+            p_block = ::operator new(sizeof(T));
+        }
+    }
+
+    try
+    {
+        return pool_unique_ptr<T>(::new (p_block) T(std::forward<Args>(args)...));
+    }
+    catch (...)
+    {
+        pool_ptr_detail::release<T>(p_block);
+        throw;
+    }
+}
+
+/**
+ * @brief   Create a shared object with control block and object in one pool block
+ * @param   pool    TPool_handle or StaticPool<> the combined allocation is taken from
+ * @param   args    Constructor arguments
+ * @return  Shared pointer to the new object
+ * @note    The pool need not be registered; the control block keeps the allocator.
+ *          The block is released when the last weak_ptr goes, not the last shared_ptr.
+ *          Falls back to the heap like PoolAllocator
+ */
+template <typename T, typename Pool, typename... Args>
+std::shared_ptr<T> pool_allocate_shared(Pool& pool, Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T, Pool>(pool), std::forward<Args>(args)...);
+}
+
+#endif /* POOL_PTR_HPP */
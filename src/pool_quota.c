@@ -0,0 +1,212 @@
+/**
+ * @file        pool_quota.c
+ * @brief       Allocation classes with quotas and a priority reserve
+ * @details     A counter is only ever raised by a compare-and-swap that checks the
+ *              limit, so concurrent admissions cannot overshoot it. Releasing a
+ *              charge is a plain atomic decrement.
+ */
+
+#include "pool_quota.h"
+#include "pool.h"
+#include "helper_routines.h"
+
+#if (POOL_QUOTA == STD_ON)
+
+/**
+ * @brief Raise a counter by one unless it already reached the limit
+ */
+static boolean charge(TPool_index* p_counter, TPool_index limit)
+{
+    TPool_index old = __atomic_load_n(p_counter, __ATOMIC_RELAXED);
+
+    do
+    {
+        if (old >= limit)
+        {
+            return FALSE;
+        }
+    } while (!__atomic_compare_exchange_n(p_counter, &old, (TPool_index)(old + 1U), TRUE,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return TRUE;
+}
+
+/**
+ * @brief Lower a counter raised by charge()
+ */
+static void uncharge(TPool_index* p_counter)
+{
+    (void)__atomic_fetch_sub(p_counter, 1U, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Block index of a pointer, or POOL_NUM_BLOCKS if it is not a block of the pool
+ */
+static uintptr block_index(const TPool_handle* p_handle, const void* p_block)
+{
+    const uint8* memory = p_handle->memory;
+    uintptr offset = (uintptr)((const uint8*)p_block - memory);
+
+    if (((const uint8*)p_block < memory) || (offset >= sizeof(p_handle->memory)) ||
+        (0U != (offset % POOL_BLOCK_SIZE)))
+    {
+        return POOL_NUM_BLOCKS;
+    }
+
+    return offset / POOL_BLOCK_SIZE;
+}
+
+/**
+ * @brief Configure an allocation class
+ *
+ * @param p_handle   Pointer to the initialized pool handle
+ * @param class_id   Class, below POOL_QUOTA_MAX_CLASSES
+ * @param max_blocks Quota of the class, 0 for no quota
+ * @param priority   POOL_PRIORITY_HIGH to let the class use the reserve
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK on invalid parameters
+ */
+Std_ReturnType pool_quota_set_class(TPool_handle* p_handle, uint32 class_id,
+                                    TPool_index max_blocks, TPool_priority priority)
+{
+    if ((NULL_PTR == p_handle) || (class_id >= POOL_QUOTA_MAX_CLASSES))
+    {
+        return STD_NOT_OK;
+    }
+
+    __atomic_store_n(&p_handle->quota.limit[class_id], max_blocks, __ATOMIC_RELAXED);
+    __atomic_store_n(&p_handle->quota.high[class_id], (boolean)(POOL_PRIORITY_HIGH == priority), __ATOMIC_RELAXED);
+
+    return STD_OK;
+}
+
+/**
+ * @brief Set the number of blocks left to high-priority classes
+ *
+ * @param p_handle Pointer to the initialized pool handle
+ * @param reserve  Size of the reserve in blocks, 0 for none
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK on invalid parameters
+ */
+Std_ReturnType pool_quota_set_reserve(TPool_handle* p_handle, TPool_index reserve)
+{
+    if ((NULL_PTR == p_handle) || (reserve > POOL_NUM_BLOCKS))
+    {
+        return STD_NOT_OK;
+    }
+
+    __atomic_store_n(&p_handle->quota.reserve, reserve, __ATOMIC_RELAXED);
+
+    return STD_OK;
+}
+
+/**
+ * @brief Allocate a block charged to an allocation class
+ *
+ * @param p_handle Pointer to the initialized pool handle
+ * @param class_id Class the block is charged to
+ * @return void*   Pointer to the block, or NULL if the allocation is refused
+ *
+ * @note  - The pool total is charged first: a normal-priority class is refused
+ *          once the classes together would reach into the reserve
+ *        - Every refusal after a successful charge gives the charge back
+ */
+void* pool_quota_alloc(TPool_handle* p_handle, uint32 class_id)
+{
+    TPool_quota* quota;
+    TPool_index total_limit;
+    TPool_index class_limit;
+    void* block;
+
+    if ((NULL_PTR == p_handle) || (class_id >= POOL_QUOTA_MAX_CLASSES))
+    {
+        return NULL_PTR;
+    }
+
+    quota = &p_handle->quota;
+    total_limit = (TRUE == __atomic_load_n(&quota->high[class_id], __ATOMIC_RELAXED)) ?
+                  (TPool_index)POOL_NUM_BLOCKS :
+                  (TPool_index)(POOL_NUM_BLOCKS - __atomic_load_n(&quota->reserve, __ATOMIC_RELAXED));
+    class_limit = __atomic_load_n(&quota->limit[class_id], __ATOMIC_RELAXED);
+    class_limit = (0U == class_limit) ? (TPool_index)POOL_NUM_BLOCKS : class_limit;
+
+    if (FALSE == charge(&quota->charged_total, total_limit))
+    {
+        return NULL_PTR;
+    }
+    if (FALSE == charge(&quota->charged[class_id], class_limit))
+    {
+        uncharge(&quota->charged_total);
+        return NULL_PTR;
+    }
+
+    block = pool_alloc_fast(p_handle);
+    if (NULL_PTR == block)
+    {
+        uncharge(&quota->charged[class_id]);
+        uncharge(&quota->charged_total);
+        return NULL_PTR;
+    }
+
+    quota->owner[block_index(p_handle, block)] = (uint8)(class_id + 1U);
+    return block;
+}
+
+/**
+ * @brief Free a block and release its charge
+ *
+ * @param p_handle Pointer to the pool handle
+ * @param p_block  Pointer to a block returned by pool_quota_alloc()
+ */
+void pool_quota_free(TPool_handle* p_handle, void* p_block)
+{
+    uintptr index;
+    uint32 class_id;
+
+    if ((NULL_PTR == p_handle) || (NULL_PTR == p_block))
+    {
+        return;
+    }
+
+    index = block_index(p_handle, p_block);
+    if ((index >= POOL_NUM_BLOCKS) || (0U == p_handle->quota.owner[index]) ||
+        (0U == pool_bit_test(p_handle->bitmap, index)))
+    {
+        return;
+    }
+
+    class_id = (uint32)p_handle->quota.owner[index] - 1U;
+    p_handle->quota.owner[index] = 0U;
+    pool_free(p_handle, p_block);
+    uncharge(&p_handle->quota.charged[class_id]);
+    uncharge(&p_handle->quota.charged_total);
+}
+
+/**
+ * @brief Get the number of blocks an allocation class holds
+ *
+ * @param p_handle Pointer to the pool handle
+ * @param class_id Class to query
+ * @return TPool_index Blocks charged to the class, 0 on invalid parameters
+ */
+TPool_index pool_quota_get_used(const TPool_handle* p_handle, uint32 class_id)
+{
+    if ((NULL_PTR == p_handle) || (class_id >= POOL_QUOTA_MAX_CLASSES))
+    {
+        return 0U;
+    }
+
+    return __atomic_load_n(&p_handle->quota.charged[class_id], __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Drop every charge after the bitmap was reset
+ *
+ * @param p_handle Pointer to the pool handle
+ */
+void pool_quota_reset(TPool_handle* p_handle)
+{
+    (void)mem_set(p_handle->quota.charged, 0, sizeof(p_handle->quota.charged));
+    (void)mem_set(p_handle->quota.owner, 0, sizeof(p_handle->quota.owner));
+    p_handle->quota.charged_total = 0U;
+}
+
+#endif
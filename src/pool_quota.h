@@ -0,0 +1,108 @@
+/**
+ * @file        pool_quota.h
+ * @brief       Allocation classes with quotas and a priority reserve
+ * @details     With POOL_QUOTA == STD_ON subsystems sharing one pool allocate through
+ *              pool_quota_alloc() and name their allocation class. Each class may
+ *              have a quota, the maximum number of blocks it holds at once, so a
+ *              runaway consumer fails on its own quota instead of draining the pool.
+ *              The last blocks of the pool form a reserve that only high-priority
+ *              classes, e.g. the control path, may take.
+ *
+ *              Admission is accounted with atomic counters: a class first charges
+ *              the pool total, then its own counter, and undoes both when either
+ *              limit or the pool refuses. No lock is taken for the accounting.
+ *
+ * @note        The counters are lock-free, the bitmap of the pool is not: the
+ *              pool_alloc() and pool_free() underneath still need the usual external
+ *              synchronization (e.g. pool_lock() of POOL_WAIT) when threads share it.
+ *              Blocks taken with plain pool_alloc() are not charged to any class and
+ *              are not held back by the reserve.
+ */
+
+#ifndef POOL_QUOTA_H
+#define POOL_QUOTA_H
+
+#include "pool_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (POOL_QUOTA == STD_ON)
+
+#if (POOL_QUOTA_MAX_CLASSES > 255U)
+#error "POOL_QUOTA_MAX_CLASSES must fit the uint8 owner of a block"
+#endif
+
+/**
+ * @brief   Priority of an allocation class
+ */
+typedef enum {
+    POOL_PRIORITY_NORMAL = 0,   /**< Stops where the reserve begins */
+    POOL_PRIORITY_HIGH          /**< May take blocks from the reserve */
+} TPool_priority;
+
+/**
+ * @brief   Configure an allocation class
+ * @param   p_handle    Pointer to the initialized pool handle
+ * @param   class_id    Class, below POOL_QUOTA_MAX_CLASSES
+ * @param   max_blocks  Quota of the class, 0 for no quota
+ * @param   priority    POOL_PRIORITY_HIGH to let the class use the reserve
+ * @return  STD_OK on success, STD_NOT_OK if p_handle is NULL or class_id is out of range
+ * @note    Lowering a quota below the blocks the class holds only stops new
+ *          allocations until enough of them are freed
+ */
+Std_ReturnType pool_quota_set_class(TPool_handle* p_handle, uint32 class_id,
+                                    TPool_index max_blocks, TPool_priority priority);
+
+/**
+ * @brief   Set the number of blocks left to high-priority classes
+ * @param   p_handle    Pointer to the initialized pool handle
+ * @param   reserve     Size of the reserve in blocks, 0 for none
+ * @return  STD_OK on success, STD_NOT_OK if p_handle is NULL or reserve > POOL_NUM_BLOCKS
+ */
+Std_ReturnType pool_quota_set_reserve(TPool_handle* p_handle, TPool_index reserve);
+
+/**
+ * @brief   Allocate a block charged to an allocation class
+ * @param   p_handle    Pointer to the initialized pool handle
+ * @param   class_id    Class the block is charged to
+ * @return  Pointer to the block, or NULL if the class is over its quota, a
+ *          normal-priority class reached the reserve, the pool is exhausted or a
+ *          parameter is invalid
+ */
+void* pool_quota_alloc(TPool_handle* p_handle, uint32 class_id);
+
+/**
+ * @brief   Free a block and release its charge
+ * @param   p_handle    Pointer to the pool handle
+ * @param   p_block     Pointer to a block returned by pool_quota_alloc()
+ * @return  None
+ * @note    The class is taken from the block. Pointers outside the pool,
+ *          misaligned pointers and blocks that are not charged are ignored.
+ */
+void pool_quota_free(TPool_handle* p_handle, void* p_block);
+
+/**
+ * @brief   Get the number of blocks an allocation class holds
+ * @param   p_handle    Pointer to the pool handle
+ * @param   class_id    Class to query
+ * @return  Blocks charged to the class, 0 on invalid parameters
+ */
+TPool_index pool_quota_get_used(const TPool_handle* p_handle, uint32 class_id);
+
+/**
+ * @brief   Drop every charge after the bitmap was reset (internal)
+ * @param   p_handle    Pointer to the pool handle
+ * @return  None
+ * @note    Called by pool_init_ex(); the classes and the reserve are kept
+ */
+void pool_quota_reset(TPool_handle* p_handle);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_QUOTA_H */
@@ -0,0 +1,124 @@
+/**
+ * @file        pool_reclaim.c
+ * @brief       Reclaim hooks run when a pool is exhausted
+ * @details     The hooks live in the pool handle, so running them on exhaustion
+ *              needs no lookup. The running flag guards against a hook that ends up
+ *              in the allocation slow path of the same pool again.
+ */
+
+#include "pool_reclaim.h"
+
+#if (POOL_RECLAIM == STD_ON)
+
+/**
+ * @brief Position of a hook in the chain, or num_hooks if it is not registered
+ */
+static uint32 find_hook(const TPool_reclaim* reclaim, TPool_reclaim_hook hook, const void* p_arg)
+{
+    uint32 i;
+
+    for (i = 0U; i < reclaim->num_hooks; i++)
+    {
+        if ((reclaim->hooks[i] == hook) && (reclaim->args[i] == p_arg))
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief Add a reclaim hook to a pool
+ *
+ * @param p_handle Pointer to the initialized pool handle
+ * @param hook     Hook to run on exhaustion
+ * @param p_arg    Argument passed to the hook
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK otherwise
+ */
+Std_ReturnType pool_reclaim_register(TPool_handle* p_handle, TPool_reclaim_hook hook, void* p_arg)
+{
+    TPool_reclaim* reclaim;
+
+    if ((NULL_PTR == p_handle) || (NULL_PTR == hook))
+    {
+        return STD_NOT_OK;
+    }
+
+    reclaim = &p_handle->reclaim;
+    if ((reclaim->num_hooks >= POOL_RECLAIM_MAX_HOOKS) ||
+        (find_hook(reclaim, hook, p_arg) < reclaim->num_hooks))
+    {
+        return STD_NOT_OK;
+    }
+
+    reclaim->hooks[reclaim->num_hooks] = hook;
+    reclaim->args[reclaim->num_hooks] = p_arg;
+    reclaim->num_hooks++;
+
+    return STD_OK;
+}
+
+/**
+ * @brief Remove a reclaim hook from a pool
+ *
+ * @param p_handle Pointer to the pool handle
+ * @param hook     Hook passed to pool_reclaim_register()
+ * @param p_arg    Argument passed to pool_reclaim_register()
+ *
+ * @note  - The remaining hooks keep their order
+ */
+void pool_reclaim_unregister(TPool_handle* p_handle, TPool_reclaim_hook hook, void* p_arg)
+{
+    TPool_reclaim* reclaim;
+    uint32 i;
+
+    if (NULL_PTR == p_handle)
+    {
+        return;
+    }
+
+    reclaim = &p_handle->reclaim;
+    for (i = find_hook(reclaim, hook, p_arg); (i + 1U) < reclaim->num_hooks; i++)
+    {
+        reclaim->hooks[i] = reclaim->hooks[i + 1U];
+        reclaim->args[i] = reclaim->args[i + 1U];
+    }
+    if (i < reclaim->num_hooks)
+    {
+        reclaim->num_hooks--;
+    }
+}
+
+/**
+ * @brief Run the reclaim hooks of an exhausted pool
+ *
+ * @param p_handle Pointer to the pool handle
+ * @return boolean TRUE if the hooks freed at least one block
+ *
+ * @note  - Stops at the first hook that frees a block, so later caches keep
+ *          their blocks as long as earlier ones can give some up
+ *        - Every run is counted in the statistics, even one without hooks
+ */
+boolean pool_reclaim_run(TPool_handle* p_handle)
+{
+    TPool_reclaim* reclaim = &p_handle->reclaim;
+    TPool_index used = p_handle->used;
+    uint32 i;
+
+    if (TRUE == reclaim->running)
+    {
+        return FALSE;
+    }
+
+    reclaim->running = TRUE;
+    reclaim->runs++;
+    for (i = 0U; (i < reclaim->num_hooks) && (p_handle->used == used); i++)
+    {
+        (void)reclaim->hooks[i](p_handle, (TPool_index)POOL_RECLAIM_BATCH, reclaim->args[i]);
+    }
+    reclaim->running = FALSE;
+
+    return (boolean)(p_handle->used < used);
+}
+
+#endif
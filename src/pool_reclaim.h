@@ -0,0 +1,65 @@
+/**
+ * @file        pool_reclaim.h
+ * @brief       Reclaim hooks run when a pool is exhausted
+ * @details     With POOL_RECLAIM == STD_ON caches built on a pool (object caches,
+ *              free lists, buffers kept for reuse) register a hook with the pool.
+ *              When the allocation slow path finds no free block it asks the hooks,
+ *              in registration order, to give up to POOL_RECLAIM_BATCH blocks back
+ *              with pool_free(). It stops at the first hook that frees a block and
+ *              retries the allocation once.
+ *
+ *              A hook that allocates from the same pool while it runs gets NULL
+ *              instead of starting another reclaim run.
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_RECLAIM_H
+#define POOL_RECLAIM_H
+
+#include "pool_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (POOL_RECLAIM == STD_ON)
+
+/**
+ * @brief   Add a reclaim hook to a pool
+ * @param   p_handle    Pointer to the initialized pool handle
+ * @param   hook        Hook to run on exhaustion
+ * @param   p_arg       Argument passed to the hook, e.g. the cache it shrinks
+ * @return  STD_OK on success, STD_NOT_OK if a parameter is NULL, the hook is
+ *          already registered with the same argument or POOL_RECLAIM_MAX_HOOKS
+ *          hooks are registered
+ */
+Std_ReturnType pool_reclaim_register(TPool_handle* p_handle, TPool_reclaim_hook hook, void* p_arg);
+
+/**
+ * @brief   Remove a reclaim hook from a pool
+ * @param   p_handle    Pointer to the pool handle
+ * @param   hook        Hook passed to pool_reclaim_register()
+ * @param   p_arg       Argument passed to pool_reclaim_register()
+ * @return  None
+ * @note    Hooks that are not registered are ignored
+ */
+void pool_reclaim_unregister(TPool_handle* p_handle, TPool_reclaim_hook hook, void* p_arg);
+
+/**
+ * @brief   Run the reclaim hooks of an exhausted pool (internal)
+ * @param   p_handle    Pointer to the pool handle
+ * @return  TRUE if the hooks freed at least one block
+ * @note    Called by the allocation slow path; returns FALSE at once while the
+ *          hooks of the pool are already running
+ */
+boolean pool_reclaim_run(TPool_handle* p_handle);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_RECLAIM_H */
@@ -0,0 +1,237 @@
+/**
+ * @file        pool_registry.c
+ * @brief       Global registry of pools for handle-less free
+ * @details     The granule table uses open addressing with linear probing. It has
+ *              four times as many entries as the at most two granules per pool, so
+ *              a probe almost always ends at the first entry. Unregistering rebuilds
+ *              the table, which keeps lookups free of tombstones.
+ */
+
+#include "pool_registry.h"
+#include "pool.h"
+#include "pool_bitmap.h"
+
+/* Number of entries in the granule table */
+#define REGISTRY_TABLE_SIZE (4U * 2U * POOL_REGISTRY_MAX_POOLS)
+
+/**
+ * @brief Granule table entry
+ */
+typedef struct registry_entry {
+    uintptr    granule;     /**< Address >> granule_shift */
+    TPool_word slots;       /**< Registry slots whose memory area overlaps the granule (0 = empty entry) */
+} TRegistry_entry;
+
+/* Registered pools, NULL for a free slot */
+static TPool_handle* registry[POOL_REGISTRY_MAX_POOLS];
+
+/* Number of registered pools */
+static uint32 registry_count = 0U;
+
+/* Granule table */
+static TRegistry_entry table[REGISTRY_TABLE_SIZE];
+
+/**
+ * @brief log2 of the granule size: the smallest power of two holding a pool memory area
+ */
+static uint32 granule_shift(void)
+{
+    uint32 shift = 0U;
+
+    while (((uint64)1U << shift) < POOL_MEMORY_SIZE)
+    {
+        shift++;
+    }
+    return shift;
+}
+
+/**
+ * @brief Home entry of a granule in the table
+ */
+static uint32 table_home(uintptr granule)
+{
+    return (uint32)((((uint64)granule * 0x9E3779B97F4A7C15ULL) >> 32) % REGISTRY_TABLE_SIZE);
+}
+
+/**
+ * @brief Find the table entry of a granule
+ * @param granule  Granule number
+ * @param create   TRUE to claim an empty entry if the granule has none
+ * @return TRegistry_entry* Entry of the granule, or NULL if it has none and create is FALSE
+ */
+static TRegistry_entry* table_find(uintptr granule, boolean create)
+{
+    uint32 i = table_home(granule);
+
+    /* The table is never more than a quarter full, so an empty entry ends the probe */
+    while (0U != table[i].slots)
+    {
+        if (table[i].granule == granule)
+        {
+            return &table[i];
+        }
+        i = (i + 1U) % REGISTRY_TABLE_SIZE;
+    }
+
+    if (TRUE == create)
+    {
+        table[i].granule = granule;
+        return &table[i];
+    }
+    return NULL_PTR;
+}
+
+/**
+ * @brief Enter the first and last granule of a registered pool into the table
+ */
+static void table_insert(uint32 slot)
+{
+    uint32 shift = granule_shift();
+    uintptr first = (uintptr)registry[slot]->memory >> shift;
+    uintptr last = ((uintptr)registry[slot]->memory + (sizeof(registry[slot]->memory) - 1U)) >> shift;
+
+    table_find(first, TRUE)->slots |= (TPool_word)1U << slot;
+    table_find(last, TRUE)->slots |= (TPool_word)1U << slot;
+}
+
+/**
+ * @brief Add a pool to the registry
+ * 
+ * @param p_handle Pointer to the pool handle
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK otherwise
+ * 
+ * @note  - Fails if p_handle is NULL, already registered or the registry is full
+ */
+Std_ReturnType pool_register(TPool_handle* p_handle)
+{
+    uint32 free_slot = POOL_REGISTRY_MAX_POOLS;
+    uint32 i;
+
+    if (NULL_PTR == p_handle)
+    {
+        return STD_NOT_OK;
+    }
+
+    for (i = 0U; i < POOL_REGISTRY_MAX_POOLS; i++)
+    {
+        if (p_handle == registry[i])
+        {
+            return STD_NOT_OK;  /* Already registered */
+        }
+        if ((NULL_PTR == registry[i]) && (free_slot >= POOL_REGISTRY_MAX_POOLS))
+        {
+            free_slot = i;
+        }
+    }
+
+    if (free_slot >= POOL_REGISTRY_MAX_POOLS)
+    {
+        return STD_NOT_OK;  /* Registry full */
+    }
+
+    registry[free_slot] = p_handle;
+    registry_count++;
+    table_insert(free_slot);
+
+    return STD_OK;
+}
+
+/**
+ * @brief Remove a pool from the registry
+ * 
+ * @param p_handle Pointer to a registered pool handle
+ * 
+ * @note  - The granule table is rebuilt from the remaining pools
+ */
+void pool_unregister(TPool_handle* p_handle)
+{
+    uint32 i;
+
+    if (NULL_PTR == p_handle)
+    {
+        return;
+    }
+
+    for (i = 0U; i < POOL_REGISTRY_MAX_POOLS; i++)
+    {
+        if (p_handle == registry[i])
+        {
+            break;
+        }
+    }
+
+    if (i >= POOL_REGISTRY_MAX_POOLS)
+    {
+        return;  /* Not registered */
+    }
+
+    registry[i] = NULL_PTR;
+    registry_count--;
+
+    for (i = 0U; i < REGISTRY_TABLE_SIZE; i++)
+    {
+        table[i].slots = 0U;
+    }
+    for (i = 0U; i < POOL_REGISTRY_MAX_POOLS; i++)
+    {
+        if (NULL_PTR != registry[i])
+        {
+            table_insert(i);
+        }
+    }
+}
+
+/**
+ * @brief Find the registered pool whose memory area contains a pointer
+ * 
+ * @param p_block Any pointer
+ * @return TPool_handle* Owning pool handle, or NULL if no registered pool owns it
+ * 
+ * @note  - One table probe and at most three range checks
+ */
+TPool_handle* pool_owns(const void* p_block)
+{
+    const TRegistry_entry* entry;
+    TPool_word slots;
+
+    if ((0U == registry_count) || (NULL_PTR == p_block))
+    {
+        return NULL_PTR;
+    }
+
+    entry = table_find((uintptr)p_block >> granule_shift(), FALSE);
+    if (NULL_PTR == entry)
+    {
+        return NULL_PTR;
+    }
+
+    for (slots = entry->slots; 0U != slots; slots &= slots - 1U)
+    {
+        TPool_handle* p_handle = registry[pool_word_ctz(slots)];
+        if (((uintptr)p_block - (uintptr)p_handle->memory) < sizeof(p_handle->memory))
+        {
+            return p_handle;
+        }
+    }
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief Free a block without knowing its pool
+ * 
+ * @param p_block Pointer to the block to free
+ * 
+ * @note  - Forwards to pool_free() on the owning pool, which validates alignment
+ *          and double frees as usual
+ *        - Pointers not owned by a registered pool are ignored
+ */
+void pool_free_ptr(void* p_block)
+{
+    TPool_handle* p_handle = pool_owns(p_block);
+
+    if (NULL_PTR != p_handle)
+    {
+        pool_free(p_handle, p_block);
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file        pool_registry.h
+ * @brief       Global registry of pools for handle-less free
+ * @details     Registered pools can be found from any pointer into their memory
+ *              area. The address space is divided into granules of the smallest
+ *              power of two holding a pool memory area, so a pool touches at most
+ *              two granules and a granule at most three pools. A small hash table
+ *              keyed on the granule number (the high address bits) maps each granule
+ *              to the registry slots overlapping it, so a lookup is one table probe
+ *              and at most three range checks, independent of the number of pools.
+ *
+ * @note        Lookups do not modify the registry. Registering and unregistering are
+ *              thread-unsafe and are meant for start-up and shutdown.
+ */
+
+#ifndef POOL_REGISTRY_H
+#define POOL_REGISTRY_H
+
+#include "pool_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (POOL_REGISTRY_MAX_POOLS > POOL_WORD_BITS)
+#error "POOL_REGISTRY_MAX_POOLS must not exceed POOL_WORD_BITS"
+#endif
+
+/**
+ * @brief   Add a pool to the registry
+ * @param   p_handle    Pointer to the pool handle
+ * @return  STD_OK on success, STD_NOT_OK if p_handle is NULL, already registered
+ *          or POOL_REGISTRY_MAX_POOLS pools are registered
+ * @note    The handle may be initialized before or after registration
+ */
+Std_ReturnType pool_register(TPool_handle* p_handle);
+
+/**
+ * @brief   Remove a pool from the registry
+ * @param   p_handle    Pointer to a registered pool handle
+ * @return  None
+ * @note    Unregistered handles are ignored
+ */
+void pool_unregister(TPool_handle* p_handle);
+
+/**
+ * @brief   Find the registered pool whose memory area contains a pointer
+ * @param   p_block     Any pointer
+ * @return  Pointer to the owning pool handle, or NULL if no registered pool owns it
+ * @note    Only the address range is checked; use pool_free_ptr() to free
+ */
+TPool_handle* pool_owns(const void* p_block);
+
+/**
+ * @brief   Free a block without knowing its pool
+ * @param   p_block     Pointer to the block to free
+ * @return  None
+ * @note    Behaves like pool_free() on the owning pool; pointers not owned by a
+ *          registered pool are ignored
+ */
+void pool_free_ptr(void* p_block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_REGISTRY_H */
@@ -0,0 +1,301 @@
+/**
+ * @file        pool_scrub.c
+ * @brief       Background scrubbing of freed pool blocks
+ * @details     Freed blocks are pushed onto a lock-free dirty stack. The worker takes
+ *              the whole stack at once, zeroes each block with non-temporal stores and
+ *              pushes it onto the clean stack. The owner of the pool takes the whole
+ *              clean stack on its allocation slow path and clears the bitmap bits.
+ *              Taking whole stacks with an exchange avoids the ABA problem of popping
+ *              single nodes.
+ */
+
+#include "pool_scrub.h"
+#include "pool_bitmap.h"
+#include "helper_routines.h"
+
+#if (POOL_SCRUB == STD_ON)
+
+#if (POOL_BLOCK_SIZE < 8U)
+#error "POOL_SCRUB requires POOL_BLOCK_SIZE to hold a pointer"
+#endif
+
+/**
+ * @brief Link field stored in the first word of a queued block
+ */
+#define NEXT_OF(block) (*(void**)(block))
+
+/**
+ * @brief Push a chain of blocks onto a lock-free stack
+ * @param p_head  Pointer to the stack head
+ * @param first   First block of the chain
+ * @param last    Last block of the chain, its link is overwritten
+ * @return void*  Previous head of the stack
+ */
+static void* push_chain(void** p_head, void* first, void* last)
+{
+    void* old = __atomic_load_n(p_head, __ATOMIC_RELAXED);
+
+    do
+    {
+        NEXT_OF(last) = old;
+    } while (!__atomic_compare_exchange_n(p_head, &old, first, TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    return old;
+}
+
+/**
+ * @brief Take every block of a lock-free stack
+ * @param p_head  Pointer to the stack head
+ * @return void*  First block of the taken chain, or NULL if the stack was empty
+ */
+static void* take_all(void** p_head)
+{
+    return __atomic_exchange_n(p_head, NULL_PTR, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Wake the worker after a push found the dirty stack empty
+ * @note  The worker only sleeps after it found the stack empty, so a push onto an
+ *        empty stack is the only one it can miss
+ */
+static void wake_worker(TPool_scrub* scrub)
+{
+    if (TRUE == scrub->started)
+    {
+        pthread_mutex_lock(&scrub->lock);
+        pthread_cond_signal(&scrub->wake);
+        pthread_mutex_unlock(&scrub->lock);
+    }
+}
+
+/**
+ * @brief Zero a block, keeping it out of the cache
+ */
+static void scrub_block(void* block)
+{
+    mem_set_nt(block, 0, POOL_BLOCK_SIZE);
+}
+
+/**
+ * @brief Worker thread: zero dirty blocks until stopped
+ * @param arg Pointer to the pool handle
+ */
+static void* scrub_worker(void* arg)
+{
+    TPool_handle* p_handle = (TPool_handle*)arg;
+    TPool_scrub* scrub = &p_handle->scrub;
+
+    pthread_mutex_lock(&scrub->lock);
+    while (TRUE == scrub->running)
+    {
+        void* block;
+
+        if (NULL_PTR == __atomic_load_n(&scrub->dirty_head, __ATOMIC_ACQUIRE))
+        {
+            pthread_cond_wait(&scrub->wake, &scrub->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&scrub->lock);
+
+        block = take_all(&scrub->dirty_head);
+        while (NULL_PTR != block)
+        {
+            void* next = NEXT_OF(block);
+
+            scrub_block(block);
+            /* Count before publishing: collect may pop the block and decrement at once */
+            __atomic_fetch_add(&scrub->clean_count, 1U, __ATOMIC_RELAXED);
+            push_chain(&scrub->clean_head, block, block);
+            __atomic_fetch_sub(&scrub->dirty_count, 1U, __ATOMIC_RELAXED);
+            block = next;
+        }
+
+        pthread_mutex_lock(&scrub->lock);
+    }
+    pthread_mutex_unlock(&scrub->lock);
+
+    return NULL_PTR;
+}
+
+/**
+ * @brief Start the background scrubber of a pool
+ * 
+ * @param p_handle Pointer to the initialized pool handle
+ * @return Std_ReturnType STD_OK if the worker runs, STD_NOT_OK otherwise
+ * 
+ * @note  - Blocks freed before the call are picked up by the worker
+ *        - The scrubber must be stopped before the pool is re-initialized
+ */
+Std_ReturnType pool_scrub_start(TPool_handle* p_handle)
+{
+    TPool_scrub* scrub;
+
+    if ((NULL_PTR == p_handle) || (TRUE == p_handle->scrub.started))
+    {
+        return STD_NOT_OK;
+    }
+
+    scrub = &p_handle->scrub;
+    pthread_mutex_init(&scrub->lock, NULL_PTR);
+    pthread_cond_init(&scrub->wake, NULL_PTR);
+    scrub->running = TRUE;
+
+    if (0 != pthread_create(&scrub->thread, NULL_PTR, scrub_worker, p_handle))
+    {
+        scrub->running = FALSE;
+        pthread_cond_destroy(&scrub->wake);
+        pthread_mutex_destroy(&scrub->lock);
+        return STD_NOT_OK;
+    }
+
+    scrub->started = TRUE;
+    return STD_OK;
+}
+
+/**
+ * @brief Stop the background scrubber of a pool and wait for it to exit
+ * 
+ * @param p_handle Pointer to the pool handle
+ * 
+ * @note  - Returns immediately if p_handle is NULL or no worker is running
+ */
+void pool_scrub_stop(TPool_handle* p_handle)
+{
+    TPool_scrub* scrub;
+
+    if ((NULL_PTR == p_handle) || (FALSE == p_handle->scrub.started))
+    {
+        return;
+    }
+
+    scrub = &p_handle->scrub;
+    pthread_mutex_lock(&scrub->lock);
+    scrub->running = FALSE;
+    pthread_cond_signal(&scrub->wake);
+    pthread_mutex_unlock(&scrub->lock);
+
+    pthread_join(scrub->thread, NULL_PTR);
+    pthread_cond_destroy(&scrub->wake);
+    pthread_mutex_destroy(&scrub->lock);
+    scrub->started = FALSE;
+}
+
+/**
+ * @brief Queue a freed block for scrubbing
+ * 
+ * @param p_handle    Pointer to the pool handle
+ * @param block_index Index of the freed block
+ * 
+ * @note  - The block stays marked in the allocation bitmap until it is collected
+ *        - The worker is woken only when the dirty list was empty
+ */
+void pool_scrub_defer(TPool_handle* p_handle, uintptr block_index)
+{
+    TPool_scrub* scrub = &p_handle->scrub;
+    void* block = &p_handle->memory[block_index * POOL_BLOCK_SIZE];
+
+    pool_bit_set(scrub->pending, block_index);
+    __atomic_fetch_add(&scrub->dirty_count, 1U, __ATOMIC_RELAXED);
+
+    if (NULL_PTR == push_chain(&scrub->dirty_head, block, block))
+    {
+        wake_worker(scrub);
+    }
+}
+
+/**
+ * @brief Return one scrubbed block to the free set
+ */
+static void release_clean(TPool_handle* p_handle, void* block)
+{
+    uintptr block_index = (uintptr)((uint8*)block - p_handle->memory) / POOL_BLOCK_SIZE;
+
+    NEXT_OF(block) = NULL_PTR;  /* Clear the link so the block is all zero again */
+    pool_bit_clear(p_handle->scrub.pending, block_index);
+    pool_bit_clear(p_handle->bitmap, block_index);
+    if ((block_index / POOL_WORD_BITS) < p_handle->hint)
+    {
+        p_handle->hint = (TPool_index)(block_index / POOL_WORD_BITS);
+    }
+}
+
+/**
+ * @brief Move scrubbed blocks back into the free set
+ * 
+ * @param p_handle Pointer to the pool handle
+ * @return boolean TRUE if at least one block became free
+ * 
+ * @note  - Called from the allocation slow path of the pool owner
+ *        - If no clean block is available yet, one dirty block is zeroed in place
+ *          so that allocation never fails while freed blocks exist
+ *        - The other dirty blocks go back to the worker, which is woken if it may
+ *          have gone to sleep on the empty stack in the meantime
+ */
+boolean pool_scrub_collect(TPool_handle* p_handle)
+{
+    TPool_scrub* scrub = &p_handle->scrub;
+    void* block = take_all(&scrub->clean_head);
+    void* rest;
+
+    if (NULL_PTR != block)
+    {
+        while (NULL_PTR != block)
+        {
+            void* next = NEXT_OF(block);
+
+            release_clean(p_handle, block);
+            __atomic_fetch_sub(&scrub->clean_count, 1U, __ATOMIC_RELAXED);
+            block = next;
+        }
+        return TRUE;
+    }
+
+    /* Nothing clean yet: scrub one dirty block here and put the others back */
+    block = take_all(&scrub->dirty_head);
+    if (NULL_PTR == block)
+    {
+        return FALSE;
+    }
+
+    rest = NEXT_OF(block);
+    if (NULL_PTR != rest)
+    {
+        void* last = rest;
+        while (NULL_PTR != NEXT_OF(last))
+        {
+            last = NEXT_OF(last);
+        }
+        if (NULL_PTR == push_chain(&scrub->dirty_head, rest, last))
+        {
+            wake_worker(scrub);
+        }
+    }
+
+    scrub_block(block);
+    release_clean(p_handle, block);
+    __atomic_fetch_sub(&scrub->dirty_count, 1U, __ATOMIC_RELAXED);
+    return TRUE;
+}
+
+/**
+ * @brief Test whether a block is queued for scrubbing
+ */
+boolean pool_scrub_is_pending(const TPool_handle* p_handle, uintptr block_index)
+{
+    return (boolean)pool_bit_test(p_handle->scrub.pending, block_index);
+}
+
+#else
+
+Std_ReturnType pool_scrub_start(TPool_handle* p_handle)
+{
+    (void)p_handle;
+    return STD_NOT_OK;  /* Scrubbing disabled by configuration */
+}
+
+void pool_scrub_stop(TPool_handle* p_handle)
+{
+    (void)p_handle;
+}
+
+#endif /* POOL_SCRUB == STD_ON */
@@ -0,0 +1,58 @@
+/**
+ * @file        pool_scrub.h
+ * @brief       Background scrubbing of freed pool blocks
+ * @details     With POOL_SCRUB == STD_ON a freed block is not returned to the free
+ *              set directly. It is queued as dirty, zeroed with non-temporal stores
+ *              by a background worker and only then handed back to the allocator,
+ *              so pool_alloc() always returns clean blocks without paying for the
+ *              clearing itself.
+ *
+ * @note        The pool itself stays single-owner: only the scrub lists are shared
+ *              with the worker thread.
+ */
+
+#ifndef POOL_SCRUB_H
+#define POOL_SCRUB_H
+
+#include "pool_types.h"
+
+/**
+ * @brief   Start the background scrubber of a pool
+ * @param   p_handle    Pointer to the initialized pool handle
+ * @return  STD_OK if the worker runs, STD_NOT_OK if p_handle is NULL, the worker
+ *          is already running, scrubbing is disabled or the thread cannot be created
+ */
+Std_ReturnType pool_scrub_start(TPool_handle* p_handle);
+
+/**
+ * @brief   Stop the background scrubber of a pool and wait for it to exit
+ * @param   p_handle    Pointer to the pool handle
+ * @return  None
+ * @note    Blocks still on the dirty list are scrubbed by the allocation slow path
+ */
+void pool_scrub_stop(TPool_handle* p_handle);
+
+/**
+ * @brief   Queue a freed block for scrubbing (internal)
+ * @param   p_handle     Pointer to the pool handle
+ * @param   block_index  Index of the block, which must be allocated and not pending
+ */
+void pool_scrub_defer(TPool_handle* p_handle, uintptr block_index);
+
+/**
+ * @brief   Move scrubbed blocks back into the free set (internal)
+ * @param   p_handle    Pointer to the pool handle
+ * @return  TRUE if at least one block became free
+ * @note    Falls back to zeroing one dirty block in place when nothing is clean yet
+ */
+boolean pool_scrub_collect(TPool_handle* p_handle);
+
+/**
+ * @brief   Test whether a block is queued for scrubbing (internal)
+ * @param   p_handle     Pointer to the pool handle
+ * @param   block_index  Index of the block
+ * @return  TRUE if the block is on the dirty or the clean list
+ */
+boolean pool_scrub_is_pending(const TPool_handle* p_handle, uintptr block_index);
+
+#endif /* POOL_SCRUB_H */
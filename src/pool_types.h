@@ -11,18 +11,241 @@
 
 #include "std_types.h"
 #include "pool_cfg.h"
+#include "compiler_abstraction.h"
+
+#if (POOL_SCRUB == STD_ON)
+#include <pthread.h>
+#endif
 
 /* Number of bits in a byte */
 #define BITS_PER_BYTE 8U
 
+/**
+ * @brief   Allocation bitmap word
+ * @details The bitmap is scanned one machine word at a time, so a single load
+ *          and bit scan covers POOL_WORD_BITS blocks.
+ */
+#if defined(__LP64__) || defined(_WIN64)
+typedef uint64 TPool_word;
+#define POOL_WORD_BITS 64U
+#else
+typedef uint32 TPool_word;
+#define POOL_WORD_BITS 32U
+#endif
+
+/**
+ * @brief   Size of the pool memory area in bytes
+ * @details Computed in 64-bit arithmetic so pools of 4 GiB and more do not overflow.
+ */
+#define POOL_MEMORY_SIZE ((uint64)(POOL_NUM_BLOCKS) * (uint64)(POOL_BLOCK_SIZE))
+
+/**
+ * @brief   Block index and block count type
+ * @details Smallest unsigned type holding 0 ... POOL_NUM_BLOCKS, so small embedded
+ *          configurations keep 8 or 16-bit metadata and large pools get 64-bit indices.
+ */
+#if ((POOL_NUM_BLOCKS) <= 0xFFU)
+typedef uint8 TPool_index;
+#elif ((POOL_NUM_BLOCKS) <= 0xFFFFU)
+typedef uint16 TPool_index;
+#elif ((POOL_NUM_BLOCKS) <= 0xFFFFFFFFU)
+typedef uint32 TPool_index;
+#else
+typedef uint64 TPool_index;
+#endif
+
+/**
+ * @brief   Byte size and byte offset type of the pool memory area
+ * @details Smallest unsigned type holding 0 ... POOL_MEMORY_SIZE.
+ */
+#if (((POOL_NUM_BLOCKS) * (POOL_BLOCK_SIZE)) <= 0xFFU)
+typedef uint8 TPool_size;
+#elif (((POOL_NUM_BLOCKS) * (POOL_BLOCK_SIZE)) <= 0xFFFFU)
+typedef uint16 TPool_size;
+#elif (((POOL_NUM_BLOCKS) * (POOL_BLOCK_SIZE)) <= 0xFFFFFFFFU)
+typedef uint32 TPool_size;
+#else
+typedef uint64 TPool_size;
+#if !(defined(__LP64__) || defined(_WIN64))
+#error "POOL_NUM_BLOCKS * POOL_BLOCK_SIZE exceeds the address space of this target"
+#endif
+#endif
+
+/**
+ * @brief   Number of words in the allocation bitmap
+ * @details Rounds POOL_NUM_BLOCKS up to whole words. Bits past POOL_NUM_BLOCKS
+ *          in the last word are never handed out.
+ */
+#define POOL_BITMAP_WORDS (((POOL_NUM_BLOCKS) + (POOL_WORD_BITS - 1U)) / POOL_WORD_BITS)
+
+/**
+ * @brief   Alignment of the pool memory area in bytes
+ * @details Lets the block kernels use full width vector stores on every block
+ *          whose size is a multiple of this value.
+ */
+#define POOL_MEMORY_ALIGN 16U
+
+#if (POOL_SCRUB == STD_ON)
+/**
+ * @brief   State of the background scrubber of one pool
+ * @details Dirty and clean blocks are chained through their first word. The lists
+ *          are lock-free stacks; the mutex and condition variable only put the
+ *          worker to sleep while there is nothing to scrub.
+ */
+typedef struct pool_scrub {
+    void*           dirty_head;                 /**< Freed blocks waiting to be zeroed (shared with the worker) */
+    void*           clean_head;                 /**< Zeroed blocks waiting to return to the bitmap (shared with the worker) */
+    TPool_index     dirty_count;                /**< Number of blocks on the dirty list */
+    TPool_index     clean_count;                /**< Number of blocks on the clean list */
+    TPool_word      pending[POOL_BITMAP_WORDS];  /**< Blocks on either list (owner thread only) */
+    boolean         running;                    /**< Worker keeps running while TRUE */
+    boolean         started;                    /**< A worker thread exists */
+    pthread_t       thread;                     /**< Worker thread */
+    pthread_mutex_t lock;                       /**< Protects running and the sleep of the worker */
+    pthread_cond_t  wake;                       /**< Signalled when the dirty list becomes non-empty or on stop */
+} TPool_scrub;
+#endif
+
+#if (POOL_WAIT == STD_ON)
+/**
+ * @brief   Lock and wait state of a pool with blocking allocation
+ * @details lock and seq are futex words. seq only changes when a free finds a
+ *          registered waiter, so frees without waiters never touch it.
+ */
+typedef struct pool_wait {
+    uint32 lock;        /**< 0 = unlocked, 1 = locked, 2 = locked with threads sleeping on it */
+    uint32 seq;         /**< Bumped by a free that wakes a waiter */
+    uint32 waiters;     /**< Threads registered in pool_alloc_wait() (under the lock) */
+} TPool_wait;
+#endif
+
+#if (POOL_WATERMARKS == STD_ON)
+/**
+ * @brief   Occupancy watermarks of a pool
+ * @details trigger is the only field read on the allocation and free paths. It holds
+ *          the used count of the next crossing plus one, so a zeroed handle is
+ *          disarmed and the used count never matches it by accident.
+ */
+typedef struct pool_watermarks {
+    uintptr     trigger;    /**< Used count of the next crossing plus one, 0 = disarmed */
+    TPool_index low;        /**< Crossing when the used count falls to this value */
+    TPool_index high;       /**< Crossing when the used count climbs to this value */
+    sint32      fd;         /**< eventfd signalled on each crossing */
+    boolean     above;      /**< The high watermark was reached and the low one not since */
+} TPool_watermarks;
+#endif
+
+#if (POOL_RECLAIM == STD_ON)
+struct pool_handle;
+
+/**
+ * @brief   Reclaim hook run when the pool is exhausted
+ * @param   p_handle    Exhausted pool
+ * @param   max_blocks  Number of blocks to give back at most
+ * @param   p_arg       Argument passed to pool_reclaim_register()
+ * @return  Number of blocks given back with pool_free()
+ */
+typedef TPool_index (*TPool_reclaim_hook)(struct pool_handle* p_handle, TPool_index max_blocks, void* p_arg);
+
+/**
+ * @brief   Reclaim hooks of a pool and their statistics
+ */
+typedef struct pool_reclaim {
+    TPool_reclaim_hook hooks[POOL_RECLAIM_MAX_HOOKS];  /**< Hooks in the order they are asked */
+    void*              args[POOL_RECLAIM_MAX_HOOKS];   /**< Argument of each hook */
+    uint32             num_hooks;                      /**< Number of registered hooks */
+    boolean            running;                        /**< Recursion guard: the hooks are being run */
+    uint64             runs;                           /**< Exhaustions that ran the hooks */
+    uint64             rescues;                        /**< Runs after which the allocation succeeded */
+} TPool_reclaim;
+#endif
+
+#if (POOL_QUOTA == STD_ON)
+/**
+ * @brief   Allocation classes of a pool
+ * @details The charged counters are only changed with atomic read-modify-write
+ *          operations, so classes on different threads admit and release blocks
+ *          without a lock. owner is written by the thread that holds the block.
+ */
+typedef struct pool_quota {
+    TPool_index limit[POOL_QUOTA_MAX_CLASSES];      /**< Quota of each class (0 = no quota) */
+    TPool_index charged[POOL_QUOTA_MAX_CLASSES];    /**< Blocks held by each class */
+    boolean     high[POOL_QUOTA_MAX_CLASSES];       /**< Class may take blocks from the reserve */
+    TPool_index reserve;                            /**< Blocks at the end of the pool left to high-priority classes */
+    TPool_index charged_total;                      /**< Blocks held by all classes */
+    uint8       owner[POOL_NUM_BLOCKS];             /**< Class of each block plus one, 0 = not charged */
+} TPool_quota;
+#endif
+
 /**
  * @brief   Memory pool handle structure
  * @details This structure contains the internal state of a memory pool.
  *          The actual memory and allocation bitmap are stored here.
  */
 typedef struct pool_handle {
-    uint8  memory[POOL_NUM_BLOCKS * POOL_BLOCK_SIZE];  /**< Raw memory pool */
-    uint8  bitmap[(POOL_NUM_BLOCKS + (BITS_PER_BYTE - 1U)) / BITS_PER_BYTE];  /**< Allocation bitmap (1 bit per block) */
+    uint8       memory[POOL_MEMORY_SIZE] ATTR_ALIGNED(POOL_MEMORY_ALIGN);  /**< Raw memory pool */
+    TPool_word  bitmap[POOL_BITMAP_WORDS];                 /**< Allocation bitmap (1 bit per block) */
+    TPool_index hint;                                      /**< Lowest bitmap word that may hold a free block; all words below it are full */
+    TPool_index used;                                      /**< Number of allocated blocks */
+    TPool_index zero_mark;                                 /**< Blocks at or above this index are still zero: never handed out since the memory area was last zeroed */
+    TPool_index trim_free;                                 /**< Free count that triggers pool_trim() when reached by a free (0 = never) */
+    uint32      trim_runs;                                 /**< Calls of pool_trim(), automatic ones included */
+#if (POOL_SCRUB == STD_ON)
+    TPool_scrub scrub;                                     /**< Background scrubber state */
+#endif
+#if (POOL_WAIT == STD_ON)
+    TPool_wait  wait;                                      /**< Lock and sleepers of pool_alloc_wait() */
+#endif
+#if (POOL_WATERMARKS == STD_ON)
+    TPool_watermarks watermarks;                           /**< Occupancy watermarks and their eventfd */
+#endif
+#if (POOL_RECLAIM == STD_ON)
+    TPool_reclaim reclaim;                                 /**< Hooks run on exhaustion */
+#endif
+#if (POOL_QUOTA == STD_ON)
+    TPool_quota quota;                                     /**< Allocation classes and the priority reserve */
+#endif
 } TPool_handle;
 
+/**
+ * @brief   What pool_init_ex() resets
+ */
+typedef enum {
+    POOL_INIT_FULL = 0,     /**< Zero the whole handle, memory area included */
+    POOL_INIT_METADATA,     /**< Reset the bitmap and counters only; the memory area is not touched */
+    POOL_INIT_ZEROED        /**< Like POOL_INIT_METADATA, for a memory area known to be all zero (e.g. unused .bss) */
+} TPool_init_mode;
+
+/**
+ * @brief   Snapshot of pool usage reported by pool_get_stats()
+ */
+typedef struct pool_stats {
+    TPool_index free_count;     /**< Blocks not held by the application (includes dirty and clean backlog) */
+    TPool_index used_count;     /**< Blocks held by the application */
+    TPool_index dirty_count;    /**< Freed blocks waiting to be zeroed by the scrubber */
+    TPool_index clean_count;    /**< Zeroed blocks waiting to return to the free set */
+    uint32      trim_runs;      /**< Calls of pool_trim(), automatic ones included */
+    uint64      reclaim_runs;   /**< Exhaustions that ran the reclaim hooks */
+    uint64      reclaim_rescues;/**< Reclaim runs after which the allocation succeeded */
+} TPool_stats;
+
+/**
+ * @brief   Kinds of invalid calls detected by the validated free path
+ */
+typedef enum {
+    POOL_VIOLATION_NULL_HANDLE = 0,     /**< Pool handle is NULL */
+    POOL_VIOLATION_NULL_BLOCK,          /**< Block pointer is NULL */
+    POOL_VIOLATION_OUT_OF_RANGE,        /**< Block pointer is outside the pool memory */
+    POOL_VIOLATION_MISALIGNED,          /**< Block pointer is not on a block boundary */
+    POOL_VIOLATION_DOUBLE_FREE          /**< Block is not currently allocated */
+} TPool_violation;
+
+/**
+ * @brief   Callback invoked when the validated free path rejects a call
+ * @param   p_handle    Pool handle passed by the caller (may be NULL)
+ * @param   p_block     Block pointer passed by the caller (may be NULL)
+ * @param   violation   Kind of violation detected
+ */
+typedef void (*TPool_violation_hook)(const TPool_handle* p_handle, const void* p_block, TPool_violation violation);
+
 #endif /* POOL_TYPES_H */
\ No newline at end of file
@@ -0,0 +1,253 @@
+/**
+ * @file        pool_vpool.c
+ * @brief       Virtual memory pool that commits memory as it grows
+ * @details     The block range is reserved with PROT_NONE and committed front to back
+ *              with mprotect(). The bitmap is mapped for the reserved maximum, but
+ *              its pages are only backed once the blocks they describe are used.
+ *              Allocation is first-fit over the committed blocks, so the pool only
+ *              grows when every committed block is in use.
+ */
+
+#include "pool_vpool.h"
+#include "pool_bitmap.h"
+#include "pool_os.h"
+
+/**
+ * @brief Round a size up to a multiple of the page size
+ */
+static uintptr round_to_pages(uintptr size, uintptr page_size)
+{
+    return (size + (page_size - 1U)) & ~(page_size - 1U);
+}
+
+/**
+ * @brief Reserve a virtual pool
+ * 
+ * @param p_vpool      Pointer to the handle to initialize
+ * @param max_blocks   Maximum number of blocks the pool can grow to
+ * @param commit_chunk Bytes committed per growth step
+ * @return Std_ReturnType STD_OK on success
+ * 
+ * @note  - Needs paged virtual memory; returns STD_NOT_OK on other targets
+ *        - A chunk smaller than one block is raised to whole pages holding one
+ *        - A chunk larger than the reservation is cut to it, so (uintptr)-1 commits
+ *          everything on the first allocation
+ *        - Returns STD_NOT_OK if max_blocks blocks do not fit in the address space
+ */
+Std_ReturnType pool_vpool_create(TPool_vpool* p_vpool, uintptr max_blocks, uintptr commit_chunk)
+{
+    uintptr page_size = pool_os_page_size();
+    uintptr num_words;
+
+    if ((NULL_PTR == p_vpool) || (0U == max_blocks) || (0U == page_size) ||
+        (max_blocks > (((uintptr)~(uintptr)0U - page_size) / POOL_BLOCK_SIZE)))
+    {
+        return STD_NOT_OK;
+    }
+
+    num_words = (max_blocks + (POOL_WORD_BITS - 1U)) / POOL_WORD_BITS;
+    p_vpool->reserved_bytes = round_to_pages(max_blocks * POOL_BLOCK_SIZE, page_size);
+    p_vpool->bitmap_bytes = round_to_pages(num_words * sizeof(TPool_word), page_size);
+    commit_chunk = (commit_chunk > POOL_BLOCK_SIZE) ? commit_chunk : POOL_BLOCK_SIZE;
+    commit_chunk = (commit_chunk < p_vpool->reserved_bytes) ? commit_chunk : p_vpool->reserved_bytes;
+    p_vpool->commit_chunk = round_to_pages(commit_chunk, page_size);  /* Cannot overflow: at most reserved_bytes */
+
+    p_vpool->memory = (uint8*)pool_os_reserve(p_vpool->reserved_bytes);
+    if (NULL_PTR == p_vpool->memory)
+    {
+        return STD_NOT_OK;
+    }
+
+    p_vpool->bitmap = (TPool_word*)pool_os_map(p_vpool->bitmap_bytes);
+    if (NULL_PTR == p_vpool->bitmap)
+    {
+        pool_os_unmap(p_vpool->memory, p_vpool->reserved_bytes);
+        p_vpool->memory = NULL_PTR;
+        return STD_NOT_OK;
+    }
+
+    p_vpool->max_blocks = max_blocks;
+    p_vpool->committed_blocks = 0U;
+    p_vpool->committed_bytes = 0U;
+    p_vpool->hint = 0U;
+    p_vpool->used = 0U;
+
+    return STD_OK;
+}
+
+/**
+ * @brief Release the whole reservation of a virtual pool
+ * 
+ * @param p_vpool Pointer to the handle
+ * 
+ * @note  - Returns immediately if p_vpool is NULL or was never created
+ */
+void pool_vpool_destroy(TPool_vpool* p_vpool)
+{
+    if ((NULL_PTR == p_vpool) || (NULL_PTR == p_vpool->memory))
+    {
+        return;
+    }
+
+    pool_os_unmap(p_vpool->bitmap, p_vpool->bitmap_bytes);
+    pool_os_unmap(p_vpool->memory, p_vpool->reserved_bytes);
+    p_vpool->memory = NULL_PTR;
+    p_vpool->bitmap = NULL_PTR;
+    p_vpool->max_blocks = 0U;
+    p_vpool->committed_blocks = 0U;
+    p_vpool->committed_bytes = 0U;
+    p_vpool->used = 0U;
+}
+
+/**
+ * @brief Commit the next chunk of the reservation
+ * 
+ * @param p_vpool Pointer to the handle
+ * @return boolean TRUE if more blocks became available
+ * 
+ * @note  - Returns FALSE when the committed pages add no whole block, so the
+ *          allocation loop always ends
+ */
+static boolean grow(TPool_vpool* p_vpool)
+{
+    uintptr size = p_vpool->commit_chunk;
+    uintptr old_blocks = p_vpool->committed_blocks;
+    uintptr limit;
+
+    if (p_vpool->committed_bytes >= p_vpool->reserved_bytes)
+    {
+        return FALSE;
+    }
+
+    if (size > (p_vpool->reserved_bytes - p_vpool->committed_bytes))
+    {
+        size = p_vpool->reserved_bytes - p_vpool->committed_bytes;
+    }
+
+    if (STD_OK != pool_os_commit(p_vpool->memory + p_vpool->committed_bytes, size))
+    {
+        return FALSE;
+    }
+
+    /* Only blocks that lie completely inside committed pages are usable */
+    p_vpool->committed_bytes += size;
+    limit = p_vpool->committed_bytes / POOL_BLOCK_SIZE;
+    p_vpool->committed_blocks = (limit < p_vpool->max_blocks) ? limit : p_vpool->max_blocks;
+
+    return (boolean)(p_vpool->committed_blocks > old_blocks);
+}
+
+/**
+ * @brief Allocate a block, committing the next chunk when the frontier is reached
+ * 
+ * @param p_vpool Pointer to the handle
+ * @return void*  Pointer to the allocated block, or NULL if allocation fails
+ * 
+ * @note  - Returns NULL if p_vpool is NULL
+ *        - The memory content is not initialized; freshly committed blocks are zero
+ */
+void* pool_vpool_alloc(TPool_vpool* p_vpool)
+{
+    uintptr block_index;
+
+    if ((NULL_PTR == p_vpool) || (NULL_PTR == p_vpool->memory))
+    {
+        return NULL_PTR;
+    }
+
+    block_index = pool_bitmap_find_free(p_vpool->bitmap, p_vpool->committed_blocks, p_vpool->hint);
+
+    /* Every committed block is in use: move the frontier */
+    while (block_index >= p_vpool->committed_blocks)
+    {
+        if (FALSE == grow(p_vpool))
+        {
+            return NULL_PTR;
+        }
+        block_index = pool_bitmap_find_free(p_vpool->bitmap, p_vpool->committed_blocks, p_vpool->hint);
+    }
+
+    p_vpool->hint = block_index / POOL_WORD_BITS;
+    pool_bit_set(p_vpool->bitmap, block_index);
+    p_vpool->used++;
+
+    return p_vpool->memory + (block_index * POOL_BLOCK_SIZE);
+}
+
+/**
+ * @brief Free a block back to the virtual pool
+ * 
+ * @param p_vpool Pointer to the handle
+ * @param p_block Pointer to the block to free
+ * 
+ * @note  - The range check covers the committed blocks, so pointers into the
+ *          reserved but uncommitted part are rejected like foreign pointers
+ *        - Committed memory is kept; the pool does not shrink
+ */
+void pool_vpool_free(TPool_vpool* p_vpool, void* p_block)
+{
+    uintptr offset;
+    uintptr block_index;
+
+    if ((NULL_PTR == p_vpool) || (NULL_PTR == p_block) || (NULL_PTR == p_vpool->memory))
+    {
+        return;
+    }
+
+    if (((uint8*)p_block < p_vpool->memory) ||
+        ((uint8*)p_block >= (p_vpool->memory + (p_vpool->committed_blocks * POOL_BLOCK_SIZE))))
+    {
+        return;  /* Invalid pointer - not from this pool */
+    }
+
+    offset = (uintptr)((uint8*)p_block - p_vpool->memory);
+    if (0U != (offset % POOL_BLOCK_SIZE))
+    {
+        return;  /* Not aligned to block boundary */
+    }
+
+    block_index = offset / POOL_BLOCK_SIZE;
+    if (0U == pool_bit_test(p_vpool->bitmap, block_index))
+    {
+        return;  /* Already free */
+    }
+
+    pool_bit_clear(p_vpool->bitmap, block_index);
+    p_vpool->used--;
+    if ((block_index / POOL_WORD_BITS) < p_vpool->hint)
+    {
+        p_vpool->hint = block_index / POOL_WORD_BITS;
+    }
+}
+
+/**
+ * @brief Get the number of free blocks up to the reserved maximum
+ * 
+ * @param p_vpool Pointer to the handle
+ * @return uintptr Number of blocks that can still be allocated
+ */
+uintptr pool_vpool_get_free_count(const TPool_vpool* p_vpool)
+{
+    if (NULL_PTR == p_vpool)
+    {
+        return 0U;
+    }
+
+    return p_vpool->max_blocks - p_vpool->used;
+}
+
+/**
+ * @brief Get the number of committed bytes
+ * 
+ * @param p_vpool Pointer to the handle
+ * @return uintptr Size of the committed part of the reservation
+ */
+uintptr pool_vpool_get_committed(const TPool_vpool* p_vpool)
+{
+    if (NULL_PTR == p_vpool)
+    {
+        return 0U;
+    }
+
+    return p_vpool->committed_bytes;
+}
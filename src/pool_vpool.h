@@ -0,0 +1,87 @@
+/**
+ * @file        pool_vpool.h
+ * @brief       Virtual memory pool that commits memory as it grows
+ * @details     A virtual pool reserves address space for its maximum number of
+ *              blocks up front but commits pages only in chunks, when allocation
+ *              reaches the committed frontier. Blocks never move, so pointers stay
+ *              valid while the pool grows, and committed memory follows the actual
+ *              peak use instead of the configured worst case.
+ *
+ * @note        Blocks are POOL_BLOCK_SIZE bytes, like in TPool_handle. This
+ *              implementation is thread-unsafe. External synchronization is required
+ *              if used in a multi-threaded environment.
+ */
+
+#ifndef POOL_VPOOL_H
+#define POOL_VPOOL_H
+
+#include "pool_types.h"
+
+/**
+ * @brief   Virtual memory pool handle
+ */
+typedef struct pool_vpool {
+    uint8*      memory;             /**< Start of the reserved range */
+    TPool_word* bitmap;             /**< Allocation bitmap sized for max_blocks */
+    uintptr     max_blocks;         /**< Number of blocks the reservation can hold */
+    uintptr     committed_blocks;   /**< Number of blocks fully inside committed pages */
+    uintptr     reserved_bytes;     /**< Size of the reserved range */
+    uintptr     committed_bytes;    /**< Size of the committed prefix of the range */
+    uintptr     bitmap_bytes;       /**< Size of the bitmap mapping */
+    uintptr     commit_chunk;       /**< Bytes committed per growth step */
+    uintptr     hint;               /**< Lowest bitmap word that may hold a free block */
+    uintptr     used;               /**< Number of allocated blocks */
+} TPool_vpool;
+
+/**
+ * @brief   Reserve a virtual pool
+ * @param   p_vpool         Pointer to the handle to initialize
+ * @param   max_blocks      Maximum number of blocks the pool can grow to
+ * @param   commit_chunk    Bytes committed per growth step (rounded up to whole pages,
+ *                          cut to the reservation; (uintptr)-1 commits it all at once)
+ * @return  STD_OK on success, STD_NOT_OK on invalid parameters or if the address
+ *          space cannot be reserved
+ * @post    No memory is committed yet
+ */
+Std_ReturnType pool_vpool_create(TPool_vpool* p_vpool, uintptr max_blocks, uintptr commit_chunk);
+
+/**
+ * @brief   Release the whole reservation of a virtual pool
+ * @param   p_vpool     Pointer to the handle
+ * @return  None
+ * @post    Every block of the pool is invalid
+ */
+void pool_vpool_destroy(TPool_vpool* p_vpool);
+
+/**
+ * @brief   Allocate a block, committing the next chunk when the frontier is reached
+ * @param   p_vpool     Pointer to the handle
+ * @return  Pointer to the allocated block, or NULL if the reservation is exhausted
+ *          or the next chunk cannot be committed
+ */
+void* pool_vpool_alloc(TPool_vpool* p_vpool);
+
+/**
+ * @brief   Free a block back to the virtual pool
+ * @param   p_vpool     Pointer to the handle
+ * @param   p_block     Pointer to the block to free
+ * @return  None
+ * @note    NULL, out-of-range, misaligned and already free pointers are ignored
+ */
+void pool_vpool_free(TPool_vpool* p_vpool, void* p_block);
+
+/**
+ * @brief   Get the number of free blocks up to the reserved maximum
+ * @param   p_vpool     Pointer to the handle
+ * @return  Number of blocks that can still be allocated, 0 if p_vpool is NULL
+ */
+uintptr pool_vpool_get_free_count(const TPool_vpool* p_vpool);
+
+/**
+ * @brief   Get the number of committed bytes
+ * @param   p_vpool     Pointer to the handle
+ * @return  Size of the committed part of the reservation, 0 if p_vpool is NULL
+ */
+uintptr pool_vpool_get_committed(const TPool_vpool* p_vpool);
+
+#endif /* POOL_VPOOL_H */
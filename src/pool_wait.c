@@ -0,0 +1,139 @@
+/**
+ * @file        pool_wait.c
+ * @brief       Blocking allocation with futex based wakeups
+ * @details     The lock is the three-state futex mutex of Drepper's "Futexes Are
+ *              Tricky": an uncontended lock and unlock are one atomic operation each
+ *              and only contention enters the kernel.
+ *
+ *              A waiter registers itself and samples the sequence word while it holds
+ *              the lock, then sleeps on the sequence word. A free that runs in between
+ *              finds the waiter registered and bumps the word, so the futex wait
+ *              returns at once and no wakeup is lost.
+ */
+
+#include "pool_wait.h"
+#include "pool.h"
+#include "pool_os.h"
+
+#if (POOL_WAIT == STD_ON)
+
+/**
+ * @brief Acquire the lock of a pool
+ *
+ * @param p_handle Pointer to the pool handle
+ */
+void pool_lock(TPool_handle* p_handle)
+{
+    uint32* lock = &p_handle->wait.lock;
+    uint32 state = 0U;
+
+    if (__atomic_compare_exchange_n(lock, &state, 1U, FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    /* Contended: mark the lock as having sleepers, then sleep until it is free */
+    if (2U != state)
+    {
+        state = __atomic_exchange_n(lock, 2U, __ATOMIC_ACQUIRE);
+    }
+    while (0U != state)
+    {
+        (void)pool_os_futex_wait(lock, 2U, POOL_WAIT_FOREVER);
+        state = __atomic_exchange_n(lock, 2U, __ATOMIC_ACQUIRE);
+    }
+}
+
+/**
+ * @brief Release the lock of a pool
+ *
+ * @param p_handle Pointer to the pool handle
+ *
+ * @note  - Enters the kernel only if a thread may be sleeping on the lock
+ */
+void pool_unlock(TPool_handle* p_handle)
+{
+    uint32* lock = &p_handle->wait.lock;
+
+    if (2U == __atomic_exchange_n(lock, 0U, __ATOMIC_RELEASE))
+    {
+        pool_os_futex_wake(lock, 1U);
+    }
+}
+
+/**
+ * @brief Allocate a block, sleeping until one is freed if the pool is exhausted
+ *
+ * @param p_handle   Pointer to the pool handle
+ * @param timeout_ns Maximum time to wait, POOL_WAIT_FOREVER or 0 to try once
+ * @return void*     Pointer to the allocated block, or NULL on timeout
+ *
+ * @note  - The lock is held while the pool is inspected and dropped while sleeping
+ *        - Every wake retries the allocation; a block taken by another thread first
+ *          sends the caller back to sleep for the rest of the timeout
+ */
+void* pool_alloc_wait(TPool_handle* p_handle, uint64 timeout_ns)
+{
+    uint64 deadline = POOL_WAIT_FOREVER;
+    void* block;
+
+    if (NULL_PTR == p_handle)
+    {
+        return NULL_PTR;
+    }
+
+    if (POOL_WAIT_FOREVER != timeout_ns)
+    {
+        deadline = pool_os_now_ns() + timeout_ns;
+    }
+
+    pool_lock(p_handle);
+    for (;;)
+    {
+        uint64 remaining = POOL_WAIT_FOREVER;
+        uint32 seq;
+
+        block = pool_alloc_fast(p_handle);
+        if (NULL_PTR != block)
+        {
+            break;
+        }
+
+        if (POOL_WAIT_FOREVER != deadline)
+        {
+            uint64 now = pool_os_now_ns();
+            if (now >= deadline)
+            {
+                break;
+            }
+            remaining = deadline - now;
+        }
+
+        seq = __atomic_load_n(&p_handle->wait.seq, __ATOMIC_RELAXED);
+        p_handle->wait.waiters++;
+        pool_unlock(p_handle);
+
+        (void)pool_os_futex_wait(&p_handle->wait.seq, seq, remaining);
+
+        pool_lock(p_handle);
+        p_handle->wait.waiters--;
+    }
+    pool_unlock(p_handle);
+
+    return block;
+}
+
+/**
+ * @brief Wake one thread sleeping in pool_alloc_wait()
+ *
+ * @param p_handle Pointer to the pool handle
+ *
+ * @note  - Runs under the pool lock, from the free path that returned one block
+ */
+void pool_wait_wake(TPool_handle* p_handle)
+{
+    (void)__atomic_add_fetch(&p_handle->wait.seq, 1U, __ATOMIC_RELEASE);
+    pool_os_futex_wake(&p_handle->wait.seq, 1U);
+}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file        pool_wait.h
+ * @brief       Blocking allocation with futex based wakeups
+ * @details     With POOL_WAIT == STD_ON a thread can sleep in pool_alloc_wait() until
+ *              another thread frees a block, instead of retrying pool_alloc() in a
+ *              loop. The handle carries a futex based lock: threads sharing the pool
+ *              call pool_alloc(), pool_free() and their variants between pool_lock()
+ *              and pool_unlock(), while pool_alloc_wait() takes the lock itself and
+ *              drops it while sleeping.
+ *
+ *              A free checks the number of registered waiters and issues a wake only
+ *              when it is non-zero, so the free path without waiters is unchanged
+ *              apart from one compare.
+ */
+
+#ifndef POOL_WAIT_H
+#define POOL_WAIT_H
+
+#include "pool_types.h"
+#include "compiler_abstraction.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Timeout of pool_alloc_wait() that never expires
+ */
+#define POOL_WAIT_FOREVER   (~0ULL)
+
+#if (POOL_WAIT == STD_ON)
+
+/**
+ * @brief   Acquire the lock of a pool
+ * @param   p_handle    Pointer to the pool handle, must not be NULL
+ * @return  None
+ * @note    Not recursive. Threads sleep on the lock when it is contended.
+ */
+void pool_lock(TPool_handle* p_handle);
+
+/**
+ * @brief   Release the lock of a pool
+ * @param   p_handle    Pointer to the pool handle, must not be NULL
+ * @return  None
+ */
+void pool_unlock(TPool_handle* p_handle);
+
+/**
+ * @brief   Allocate a block, sleeping until one is freed if the pool is exhausted
+ * @param   p_handle    Pointer to the pool handle
+ * @param   timeout_ns  Maximum time to wait in nanoseconds, POOL_WAIT_FOREVER to
+ *                      wait without limit, 0 to try once
+ * @return  Pointer to the allocated block, or NULL if p_handle is NULL or the
+ *          timeout expired
+ * @pre     The caller does not hold the pool lock
+ */
+void* pool_alloc_wait(TPool_handle* p_handle, uint64 timeout_ns);
+
+/**
+ * @brief   Wake one thread sleeping in pool_alloc_wait() (internal)
+ * @param   p_handle    Pointer to the pool handle
+ * @return  None
+ * @note    Called by the free paths when waiters are registered
+ */
+ATTR_COLD void pool_wait_wake(TPool_handle* p_handle);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_WAIT_H */
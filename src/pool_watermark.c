@@ -0,0 +1,109 @@
+/**
+ * @file        pool_watermark.c
+ * @brief       Occupancy watermark notifications through an eventfd
+ * @details     The trigger always holds the used count of the next crossing plus
+ *              one: high + 1 while the pool is below the high watermark, low + 1 once
+ *              it was reached. Crossing swaps the two and signals the eventfd.
+ */
+
+#include "pool_watermark.h"
+#include "pool_os.h"
+
+#if (POOL_WATERMARKS == STD_ON)
+
+/**
+ * @brief Arm the watermark on the far side of the current state
+ */
+static void arm(TPool_handle* p_handle)
+{
+    TPool_watermarks* wm = &p_handle->watermarks;
+
+    wm->trigger = (TRUE == wm->above) ? ((uintptr)wm->low + 1U) : ((uintptr)wm->high + 1U);
+}
+
+/**
+ * @brief Signal an eventfd whenever the occupancy crosses a watermark
+ *
+ * @param p_handle Pointer to the initialized pool handle
+ * @param low      Used count at which a fall is signalled
+ * @param high     Used count at which a climb is signalled
+ * @param fd       eventfd to signal, negative to disable the watermarks
+ * @return Std_ReturnType STD_OK on success, STD_NOT_OK on invalid parameters
+ */
+Std_ReturnType pool_set_watermarks(TPool_handle* p_handle, TPool_index low, TPool_index high, sint32 fd)
+{
+    TPool_watermarks* wm;
+
+    if (NULL_PTR == p_handle)
+    {
+        return STD_NOT_OK;
+    }
+
+    wm = &p_handle->watermarks;
+    if (fd < 0)
+    {
+        wm->trigger = 0U;
+        wm->fd = -1;
+        wm->above = FALSE;
+        return STD_OK;
+    }
+
+    if ((low >= high) || (high > POOL_NUM_BLOCKS))
+    {
+        return STD_NOT_OK;
+    }
+
+    wm->low = low;
+    wm->high = high;
+    wm->fd = fd;
+    wm->above = (boolean)(p_handle->used >= high);
+    arm(p_handle);
+
+    return STD_OK;
+}
+
+/**
+ * @brief Tell on which side of the watermarks the pool is
+ *
+ * @param p_handle Pointer to the pool handle
+ * @return boolean TRUE between a climb to high and the next fall to low
+ */
+boolean pool_watermark_is_high(const TPool_handle* p_handle)
+{
+    return (NULL_PTR != p_handle) ? p_handle->watermarks.above : FALSE;
+}
+
+/**
+ * @brief Signal a crossing and arm the opposite watermark
+ *
+ * @param p_handle Pointer to the pool handle
+ *
+ * @note  - A failed eventfd write is not retried; the state still flips so the
+ *          next crossing is reported
+ */
+void pool_watermark_cross(TPool_handle* p_handle)
+{
+    TPool_watermarks* wm = &p_handle->watermarks;
+
+    wm->above = (boolean)(FALSE == wm->above);
+    arm(p_handle);
+    (void)pool_os_event_signal(wm->fd);
+}
+
+/**
+ * @brief Re-arm the watermarks after the used count was reset
+ *
+ * @param p_handle Pointer to the pool handle
+ *
+ * @note  - A pool above the high watermark has just fallen below the low one,
+ *          which is signalled like any other crossing
+ */
+void pool_watermark_reset(TPool_handle* p_handle)
+{
+    if ((0U != p_handle->watermarks.trigger) && (TRUE == p_handle->watermarks.above))
+    {
+        pool_watermark_cross(p_handle);
+    }
+}
+
+#endif
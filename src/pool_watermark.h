@@ -0,0 +1,80 @@
+/**
+ * @file        pool_watermark.h
+ * @brief       Occupancy watermark notifications through an eventfd
+ * @details     With POOL_WATERMARKS == STD_ON an event loop can be told when the
+ *              number of allocated blocks climbs to a high watermark and when it
+ *              falls back to a low one, e.g. to stop and resume reading sockets.
+ *              Each crossing adds one to an eventfd that the loop polls together
+ *              with its other descriptors.
+ *
+ *              Only one crossing can be next: below the high watermark only an
+ *              allocation can cross, above it only a free. The allocation and free
+ *              paths therefore compare the used count against a single trigger value.
+ */
+
+#ifndef POOL_WATERMARK_H
+#define POOL_WATERMARK_H
+
+#include "pool_types.h"
+#include "compiler_abstraction.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (POOL_WATERMARKS == STD_ON)
+
+/**
+ * @brief   Signal an eventfd whenever the occupancy crosses a watermark
+ * @param   p_handle    Pointer to the initialized pool handle
+ * @param   low         Used count at which a fall from the high watermark is signalled
+ * @param   high        Used count at which a climb is signalled
+ * @param   fd          eventfd to signal, negative to disable the watermarks
+ * @return  STD_OK on success, STD_NOT_OK if p_handle is NULL or not low < high <= POOL_NUM_BLOCKS
+ * @note    The state is taken from the current used count without signalling:
+ *          a pool that already holds high blocks or more waits for the fall to low
+ */
+Std_ReturnType pool_set_watermarks(TPool_handle* p_handle, TPool_index low, TPool_index high, sint32 fd);
+
+/**
+ * @brief   Tell on which side of the watermarks the pool is
+ * @param   p_handle    Pointer to the pool handle
+ * @return  TRUE from a climb to the high watermark until the next fall to the low one
+ * @note    Lets the event loop tell the two crossings apart after reading the eventfd
+ */
+boolean pool_watermark_is_high(const TPool_handle* p_handle);
+
+/**
+ * @brief   Signal a crossing and arm the opposite watermark (internal)
+ * @param   p_handle    Pointer to the pool handle
+ * @return  None
+ */
+ATTR_COLD void pool_watermark_cross(TPool_handle* p_handle);
+
+/**
+ * @brief   Check the used count against the armed watermark (internal)
+ * @param   p_handle    Pointer to the pool handle, after its used count changed
+ * @return  None
+ */
+LOCAL_INLINE void pool_watermark_check(TPool_handle* p_handle)
+{
+    if (UNLIKELY(((uintptr)p_handle->used + 1U) == p_handle->watermarks.trigger))
+    {
+        pool_watermark_cross(p_handle);
+    }
+}
+
+/**
+ * @brief   Re-arm the watermarks after the used count was reset (internal)
+ * @param   p_handle    Pointer to the pool handle
+ * @return  None
+ */
+void pool_watermark_reset(TPool_handle* p_handle);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_WATERMARK_H */
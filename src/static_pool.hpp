@@ -0,0 +1,246 @@
+/**
+ * @file        static_pool.hpp
+ * @brief       Header-only C++ static memory pool
+ * @details     StaticPool<BlockSize, N, Align> has the semantics of TPool_handle
+ *              (first-fit allocation of fixed-size blocks from a bitmap, validated
+ *              free) with everything the C version takes from pool_cfg.h chosen at
+ *              compile time from the template parameters:
+ *              - the bitmap word is the smallest unsigned type holding N bits when
+ *                N <= 64, so the whole bitmap lives in one register and allocation
+ *                is a single bit scan without a search loop or hint
+ *              - larger pools use machine words and the search hint of pool.c
+ *              - counters use the smallest unsigned type holding N
+ *              - block index and offset math divides by the constant BlockSize
+ *
+ * @note        This implementation is thread-unsafe. External synchronization is
+ *              required if used in a multi-threaded environment.
+ */
+
+#ifndef STATIC_POOL_HPP
+#define STATIC_POOL_HPP
+
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include "std_types.h"
+
+namespace static_pool_detail
+{
+    /**
+     * @brief Smallest unsigned type holding the value Max
+     */
+    template <uint64 Max>
+    using least_uint = std::conditional_t<(Max <= 0xFFU), uint8,
+                       std::conditional_t<(Max <= 0xFFFFU), uint16,
+                       std::conditional_t<(Max <= 0xFFFFFFFFU), uint32, uint64>>>;
+
+    /**
+     * @brief Bitmap word for N blocks: one word of at least N bits up to 64 blocks,
+     *        machine words above
+     */
+    template <uintptr N>
+    using bitmap_word = std::conditional_t<(N <= 64U), least_uint<(N >= 64U) ? ~0ULL : ((1ULL << N) - 1U)>,
+                        std::conditional_t<(sizeof(void*) >= 8U), uint64, uint32>>;
+
+    /**
+     * @brief Largest power of two dividing BlockSize, capped at the fundamental alignment
+     */
+    template <uintptr BlockSize>
+    inline constexpr uintptr default_align = ((BlockSize & (~BlockSize + 1U)) < alignof(std::max_align_t))
+                                             ? (BlockSize & (~BlockSize + 1U)) : alignof(std::max_align_t);
+}
+
+/**
+ * @brief   Static memory pool of N blocks of BlockSize bytes
+ * @tparam  BlockSize   Size of each block in bytes, a multiple of Align
+ * @tparam  N           Number of blocks
+ * @tparam  Align       Alignment of every block, a power of two (default: the largest
+ *                      power of two dividing BlockSize, at most alignof(std::max_align_t))
+ *
+ * @note    The constructor is constexpr and leaves all storage zero, so a pool can
+ *          be declared constinit and is placed in .bss without start-up code.
+ */
+template <uintptr BlockSize, uintptr N, uintptr Align = static_pool_detail::default_align<BlockSize>>
+class StaticPool
+{
+    static_assert((BlockSize > 0U) && (N > 0U), "StaticPool needs a non-empty pool");
+    static_assert(std::has_single_bit(Align), "Align must be a power of two");
+    static_assert((BlockSize % Align) == 0U, "BlockSize must be a multiple of Align");
+
+public:
+    using word_type = static_pool_detail::bitmap_word<N>;   /**< Bitmap word */
+    using index_type = static_pool_detail::least_uint<N>;   /**< Block index and count type */
+
+    static constexpr uintptr block_size = BlockSize;        /**< Size of each block in bytes */
+    static constexpr uintptr capacity = N;                  /**< Number of blocks */
+    static constexpr uintptr alignment = Align;             /**< Alignment of every block */
+
+    constexpr StaticPool() noexcept = default;
+    StaticPool(const StaticPool&) = delete;
+    StaticPool& operator=(const StaticPool&) = delete;
+
+    /**
+     * @brief  Allocate the lowest free block
+     * @return Pointer to the block, or nullptr if every block is allocated
+     */
+    void* allocate() noexcept
+    {
+        if constexpr (single_word)
+        {
+            const word_type free_bits = static_cast<word_type>(~bitmap_[0] & valid_mask);
+            if (free_bits == 0U) [[unlikely]]
+            {
+                return nullptr;
+            }
+            bitmap_[0] |= static_cast<word_type>(free_bits & (0U - free_bits));  /* Lowest free bit */
+            ++used_;
+            return &memory_[static_cast<uintptr>(std::countr_zero(free_bits)) * BlockSize];
+        }
+        else
+        {
+            for (uintptr i = hint_; i < num_words; ++i)
+            {
+                const word_type free_bits = static_cast<word_type>(~bitmap_[i]);
+                if (free_bits != 0U)
+                {
+                    const uintptr index = (i * word_bits) + static_cast<uintptr>(std::countr_zero(free_bits));
+                    if (index >= N)
+                    {
+                        break;  /* Padding bits of the last word */
+                    }
+                    hint_ = static_cast<index_type>(i);
+                    bitmap_[i] |= static_cast<word_type>(free_bits & (0U - free_bits));
+                    ++used_;
+                    return &memory_[index * BlockSize];
+                }
+            }
+            hint_ = static_cast<index_type>(num_words - 1U);
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief  Free a block, ignoring invalid pointers
+     * @param  p_block  Pointer to the block to free
+     * @note   Pointers outside the pool, not on a block boundary or to a free block
+     *         are ignored, like pool_free()
+     */
+    void deallocate(void* p_block) noexcept
+    {
+        const uintptr offset = reinterpret_cast<uintptr>(p_block) - reinterpret_cast<uintptr>(&memory_[0]);
+        if ((offset >= sizeof(memory_)) || ((offset % BlockSize) != 0U)) [[unlikely]]
+        {
+            return;
+        }
+        const uintptr index = offset / BlockSize;
+        if (((bitmap_[index / word_bits] >> (index % word_bits)) & 1U) == 0U) [[unlikely]]
+        {
+            return;  /* Double free */
+        }
+        release(index);
+    }
+
+    /**
+     * @brief  Free a block without validation on trusted call paths
+     * @param  p_block  Pointer to a block allocated from this pool
+     * @note   Counterpart of pool_free_fast()
+     */
+    void deallocate_unchecked(void* p_block) noexcept
+    {
+        release((reinterpret_cast<uintptr>(p_block) - reinterpret_cast<uintptr>(&memory_[0])) / BlockSize);
+    }
+
+    /**
+     * @brief  Test whether a pointer is a block of this pool
+     * @param  p_block  Any pointer
+     * @return true if p_block lies on a block boundary inside the pool memory
+     */
+    bool owns(const void* p_block) const noexcept
+    {
+        const uintptr offset = reinterpret_cast<uintptr>(p_block) - reinterpret_cast<uintptr>(&memory_[0]);
+        return (offset < sizeof(memory_)) && ((offset % BlockSize) == 0U);
+    }
+
+    /**
+     * @brief  Test whether a pointer is a currently allocated block of this pool
+     * @param  p_block  Any pointer
+     * @return true if owns(p_block) and the block is allocated
+     */
+    bool is_allocated(const void* p_block) const noexcept
+    {
+        if (!owns(p_block))
+        {
+            return false;
+        }
+        const uintptr index = (reinterpret_cast<uintptr>(p_block) - reinterpret_cast<uintptr>(&memory_[0])) / BlockSize;
+        return ((bitmap_[index / word_bits] >> (index % word_bits)) & 1U) != 0U;
+    }
+
+    /**
+     * @brief  Call a function for every allocated block, in address order
+     * @param  func  Callable taking a void* to the block
+     * @note   func may free the block it is called for
+     */
+    template <typename Func>
+    void for_each_allocated(Func&& func)
+    {
+        for (uintptr i = 0U; i < num_words; ++i)
+        {
+            for (word_type bits = bitmap_[i]; bits != 0U; bits = static_cast<word_type>(bits & (bits - 1U)))
+            {
+                func(static_cast<void*>(&memory_[((i * word_bits) + static_cast<uintptr>(std::countr_zero(bits))) * BlockSize]));
+            }
+        }
+    }
+
+    /**
+     * @brief  Number of free blocks
+     */
+    index_type free_count() const noexcept
+    {
+        return static_cast<index_type>(N - used_);
+    }
+
+    /**
+     * @brief  Mark every block free; the memory is not touched
+     */
+    void reset() noexcept
+    {
+        for (uintptr i = 0U; i < num_words; ++i)
+        {
+            bitmap_[i] = 0U;
+        }
+        hint_ = 0U;
+        used_ = 0U;
+    }
+
+private:
+    static constexpr uintptr word_bits = sizeof(word_type) * 8U;
+    static constexpr uintptr num_words = (N + (word_bits - 1U)) / word_bits;
+    static constexpr bool single_word = (num_words == 1U);
+    static constexpr word_type valid_mask = (N >= word_bits) ? static_cast<word_type>(~word_type{0U})
+                                                             : static_cast<word_type>((word_type{1U} << N) - 1U);
+
+    /**
+     * @brief  Clear the bit of an allocated block
+     */
+    void release(uintptr index) noexcept
+    {
+        bitmap_[index / word_bits] &= static_cast<word_type>(~(word_type{1U} << (index % word_bits)));
+        --used_;
+        if constexpr (!single_word)
+        {
+            if ((index / word_bits) < hint_)
+            {
+                hint_ = static_cast<index_type>(index / word_bits);
+            }
+        }
+    }
+
+    alignas(Align) std::byte memory_[BlockSize * N] {};    /**< Raw memory pool */
+    word_type  bitmap_[num_words] {};                       /**< Allocation bitmap (1 = allocated) */
+    index_type hint_ {};                                    /**< Lowest word that may hold a free block (multi-word pools) */
+    index_type used_ {};                                    /**< Number of allocated blocks */
+};
+
+#endif /* STATIC_POOL_HPP */